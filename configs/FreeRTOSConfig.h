@@ -104,6 +104,8 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay              1
 #define INCLUDE_xTaskIsTaskFinished     1
 #define INCLUDE_xTimerPendFunctionCall  1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_xTaskGetSchedulerState 1
 
 /*
 Interrupt nesting behavior configuration.
@@ -185,5 +187,10 @@ extern void vApplicationSleep( uint32_t xExpectedIdleTime );
 #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   CY_CFG_PWR_DEEPSLEEP_LATENCY
 #endif
 
+/* Kernel event tracing into a binary ring, see source/pasco2_trace.h */
+#if defined(PASCO2_TRACE_ENABLED) && (defined(__ICCARM__) || defined(__GNUC__))
+#include "pasco2_trace.h"
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
 
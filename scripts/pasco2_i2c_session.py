@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Convert a pasco2 I2C transfer recording into a replay session.
+
+The input is either the hex dump printed by the 'l' terminal command (the
+complete terminal log can be passed, the text between the
+PASCO2-I2C-BEGIN/END markers is used) or a raw binary image of the
+pasco2_i2c_recording symbol saved with the debugger.
+
+The recording keeps the first transfers after boot (the prologue) and a ring
+of the latest transfers, which is frozen by a communication error or a busy
+sensor. The ring is put back into time order. When transfers between the
+prologue and the ring were overwritten, the first ring transfer is flagged so
+that the replay resynchronizes there, like the recorder flags the first
+transfer after the transfers dropped during a manual dump.
+
+The output is a C source file defining pasco2_i2c_session, which is replayed
+by source/pasco2_i2c_replay.c when the application is built with
+PASCO2_I2C_REPLAY_ENABLED. With --list the transfers are printed instead.
+
+Usage: pasco2_i2c_session.py [--list] <input> [<output.c>]
+"""
+
+import struct
+import sys
+
+RECORD_MAGIC = 0x43324950
+RECORD_VERSION = 2
+DATA_SIZE = 12
+
+HEADER = struct.Struct("<IHHIIIIII")
+RECORD = struct.Struct("<IIBBBB%ds" % DATA_SIZE)
+
+OP_NO_STOP = 0x80
+OP_RESYNC = 0x40
+OP_NAMES = {1: "write", 2: "read", 3: "mem_write", 4: "mem_read"}
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] == struct.pack("<I", RECORD_MAGIC):
+        return data
+    text = data.decode("ascii", errors="ignore")
+    begin = text.rfind("PASCO2-I2C-BEGIN")
+    end = text.find("PASCO2-I2C-END", begin)
+    if begin < 0 or end < 0:
+        sys.exit("no recording found in " + path)
+    body = text[begin + len("PASCO2-I2C-BEGIN"):end]
+    return bytes.fromhex("".join(body.split()))
+
+
+def parse(data):
+    (magic, version, record_size, capacity, prologue, count, dropped, frozen,
+     trigger) = HEADER.unpack_from(data, 0)
+    if magic != RECORD_MAGIC or version != RECORD_VERSION or record_size != RECORD.size:
+        sys.exit("unsupported recording layout")
+    stored = min(count, capacity)
+    if (len(data) - HEADER.size) // RECORD.size < stored:
+        sys.exit("the recording is truncated")
+    records = [list(RECORD.unpack_from(data, HEADER.size + i * RECORD.size)) for i in range(stored)]
+    lost = count - stored
+    if lost:
+        # The oldest ring record is the one which would be overwritten next
+        ring = records[prologue:]
+        oldest = (count - prologue) % len(ring)
+        ring = ring[oldest:] + ring[:oldest]
+        ring[0][2] |= OP_RESYNC
+        records = records[:prologue] + ring
+    return records, {"lost": lost, "dropped": dropped, "frozen": frozen, "trigger": trigger}
+
+
+def listing(records):
+    lines = []
+    start = records[0][0] if records else 0
+    for timestamp, result, op, address, mem_addr, size, payload in records:
+        if op & OP_RESYNC:
+            lines.append("%10s     ... transfers missing from the recording ..." % "")
+            op &= ~OP_RESYNC
+        name = OP_NAMES.get(op & ~OP_NO_STOP, "op%d" % op)
+        if op & OP_NO_STOP:
+            name += " (no stop)"
+        if (op & ~OP_NO_STOP) in (3, 4):
+            name += " [0x%02x]" % mem_addr
+        lines.append("%10d ms  0x%02x  %-24s %-36s result 0x%08x" % (
+            timestamp - start, address, name, payload[:min(size, DATA_SIZE)].hex(" "), result))
+    return "\n".join(lines)
+
+
+def summary(info):
+    text = ""
+    if info["lost"]:
+        text += "%d transfers between the prologue and the ring are missing. " % info["lost"]
+    if info["frozen"]:
+        text += "Frozen by result 0x%08x, %d later transfers are missing." % (info["trigger"], info["dropped"])
+    return text.strip()
+
+
+def source(records, info):
+    lines = [
+        "/* Generated by scripts/pasco2_i2c_session.py, do not edit */",
+        "",
+        "/* Header file for local module */",
+        '#include "pasco2_i2c_record.h"',
+        "",
+    ]
+    if summary(info):
+        lines.append("/* %s */" % summary(info))
+    lines.append("const pasco2_i2c_record_t pasco2_i2c_session[] = {")
+    for timestamp, result, op, address, mem_addr, size, payload in records:
+        data = ", ".join("0x%02x" % b for b in payload[:min(size, DATA_SIZE)])
+        lines.append("    {%du, 0x%08xu, 0x%02xu, 0x%02xu, 0x%02xu, %du, {%s}}," % (
+            timestamp, result, op, address, mem_addr, size, data))
+    lines.append("};")
+    lines.append("const uint32_t pasco2_i2c_session_length =")
+    lines.append("    sizeof(pasco2_i2c_session) / sizeof(pasco2_i2c_session[0]);")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    args = sys.argv[1:]
+    list_only = "--list" in args
+    args = [a for a in args if a != "--list"]
+    if len(args) != (1 if list_only else 2):
+        sys.exit(__doc__)
+
+    records, info = parse(load(args[0]))
+    if list_only:
+        print(listing(records))
+        if summary(info):
+            print(summary(info))
+        return
+    if not records:
+        sys.exit("the recording is empty")
+    with open(args[1], "w") as f:
+        f.write(source(records, info))
+    print("%d transfers written to %s" % (len(records), args[1]))
+
+
+if __name__ == "__main__":
+    main()
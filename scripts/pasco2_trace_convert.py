@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Convert a pasco2 kernel event trace into the Chrome trace event format.
+
+The input is either the hex dump printed by the 't' terminal command (the
+complete terminal log can be passed, the text between the
+PASCO2-TRACE-BEGIN/END markers is used) or a raw binary image of the
+pasco2_trace_buffer symbol saved with the debugger. The output JSON can be
+opened with https://ui.perfetto.dev or chrome://tracing.
+
+Usage: pasco2_trace_convert.py <input> <output.json>
+"""
+
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x52544350
+TRACE_VERSION = 1
+
+HEADER = struct.Struct("<IHHIII")
+NAME = struct.Struct("<B3xI16s")
+RECORD = struct.Struct("<IIHH")
+NAME_ENTRIES = 16
+
+EVT_TASK_SWITCHED_IN = 1
+EVT_TASK_SWITCHED_OUT = 2
+EVT_MUTEX_TAKE = 3
+EVT_MUTEX_TAKE_FAILED = 4
+EVT_MUTEX_BLOCK = 5
+EVT_MUTEX_GIVE = 6
+EVT_PRIORITY_INHERIT = 7
+EVT_PRIORITY_RESTORE = 8
+EVT_NOTIFY = 9
+EVT_NOTIFY_FROM_ISR = 10
+EVT_NOTIFY_WAIT = 11
+EVT_ISR_ENTER = 12
+EVT_ISR_EXIT = 13
+EVT_SPAN_BEGIN = 14
+EVT_SPAN_END = 15
+
+OBJECT_TASK = 1
+OBJECT_MUTEX = 2
+
+SPAN_NAMES = {1: "mtb_pasco2_init", 2: "mtb_pasco2_get_ppm", 3: "mtb_pasco2_set_config"}
+
+PID = 1
+ISR_TID = 0x10000
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] == struct.pack("<I", TRACE_MAGIC):
+        return data
+    text = data.decode("ascii", errors="ignore")
+    begin = text.rfind("PASCO2-TRACE-BEGIN")
+    end = text.find("PASCO2-TRACE-END", begin)
+    if begin < 0 or end < 0:
+        sys.exit("no trace found in " + path)
+    body = text[begin + len("PASCO2-TRACE-BEGIN"):end]
+    return bytes.fromhex("".join(body.split()))
+
+
+def parse(data):
+    magic, version, record_size, capacity, head, timestamp_hz = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC or version != TRACE_VERSION or record_size != RECORD.size:
+        sys.exit("unsupported trace layout")
+
+    names = {}
+    offset = HEADER.size
+    for _ in range(NAME_ENTRIES):
+        obj_type, obj_id, name = NAME.unpack_from(data, offset)
+        offset += NAME.size
+        if obj_type != 0:
+            names[(obj_type, obj_id)] = name.split(b"\0", 1)[0].decode("ascii", errors="replace")
+
+    # Records are stored in a ring, the oldest one follows the newest
+    count = min(head, capacity)
+    records = []
+    for i in range(head - count, head):
+        records.append(RECORD.unpack_from(data, offset + (i % capacity) * RECORD.size))
+    return timestamp_hz, names, records
+
+
+def convert(timestamp_hz, names, records):
+    events = []
+    tasks = set()
+
+    def task_name(number):
+        return names.get((OBJECT_TASK, number), "task %d" % number)
+
+    def mutex_name(handle):
+        return names.get((OBJECT_MUTEX, handle), "mutex 0x%08x" % handle)
+
+    # Unwrap the 32 bit cycle counter
+    wraps = 0
+    previous = None
+    current_task = 0
+    for timestamp, arg, event, aux in records:
+        if previous is not None and timestamp < previous:
+            wraps += 1
+        previous = timestamp
+        ts = ((wraps << 32) + timestamp) * 1e6 / timestamp_hz
+
+        if event == EVT_TASK_SWITCHED_IN:
+            current_task = arg
+            tasks.add(arg)
+            events.append({"ph": "B", "name": task_name(arg), "pid": PID, "tid": arg, "ts": ts,
+                           "args": {"priority": aux}})
+        elif event == EVT_TASK_SWITCHED_OUT:
+            tasks.add(arg)
+            events.append({"ph": "E", "pid": PID, "tid": arg, "ts": ts})
+        elif event in (EVT_MUTEX_TAKE, EVT_MUTEX_TAKE_FAILED, EVT_MUTEX_BLOCK, EVT_MUTEX_GIVE):
+            label = {EVT_MUTEX_TAKE: "take", EVT_MUTEX_TAKE_FAILED: "take failed",
+                     EVT_MUTEX_BLOCK: "block", EVT_MUTEX_GIVE: "give"}[event]
+            events.append({"ph": "i", "s": "t", "name": "%s %s" % (label, mutex_name(arg)), "pid": PID,
+                           "tid": current_task, "ts": ts})
+        elif event in (EVT_PRIORITY_INHERIT, EVT_PRIORITY_RESTORE):
+            label = "inherit" if event == EVT_PRIORITY_INHERIT else "restore"
+            events.append({"ph": "i", "s": "p", "name": "priority %s %s -> %d" % (label, task_name(arg), aux),
+                           "pid": PID, "tid": arg, "ts": ts})
+        elif event in (EVT_NOTIFY, EVT_NOTIFY_FROM_ISR, EVT_NOTIFY_WAIT):
+            label = {EVT_NOTIFY: "notify", EVT_NOTIFY_FROM_ISR: "notify from isr",
+                     EVT_NOTIFY_WAIT: "wait for notification"}[event]
+            events.append({"ph": "i", "s": "t", "name": "%s %s" % (label, task_name(arg)), "pid": PID,
+                           "tid": current_task, "ts": ts})
+        elif event in (EVT_ISR_ENTER, EVT_ISR_EXIT):
+            events.append({"ph": "B" if event == EVT_ISR_ENTER else "E", "name": "irq %d" % arg, "pid": PID,
+                           "tid": ISR_TID, "ts": ts})
+        elif event in (EVT_SPAN_BEGIN, EVT_SPAN_END):
+            # A span may outlive the task slice it started in, async events
+            # keep it from breaking the nesting of the task B/E events
+            entry = {"ph": "b" if event == EVT_SPAN_BEGIN else "e", "cat": "sensor", "id": arg, "pid": PID,
+                     "tid": current_task, "ts": ts, "name": SPAN_NAMES.get(arg, "span %d" % arg)}
+            if event == EVT_SPAN_END:
+                entry["args"] = {"result": aux}
+            events.append(entry)
+
+    for number in sorted(tasks):
+        events.append({"ph": "M", "name": "thread_name", "pid": PID, "tid": number,
+                       "args": {"name": task_name(number)}})
+    events.append({"ph": "M", "name": "thread_name", "pid": PID, "tid": ISR_TID, "args": {"name": "ISR"}})
+    events.append({"ph": "M", "name": "process_name", "pid": PID, "args": {"name": "FreeRTOS"}})
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    timestamp_hz, names, records = parse(load(sys.argv[1]))
+    with open(sys.argv[2], "w") as f:
+        json.dump(convert(timestamp_hz, names, records), f)
+    print("%d events converted" % len(records))
+
+
+if __name__ == "__main__":
+    main()
@@ -34,8 +34,13 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "pasco2_board.h"
+#include "pasco2_executor.h"
+#include "pasco2_health.h"
+#include "pasco2_print.h"
 #include "pasco2_task.h"
 #include "pasco2_terminal_ui_task.h"
+#include "pasco2_trace.h"
 
 /*******************************************************************************
  * Global Variables
@@ -76,41 +81,59 @@ int main(void)
         CY_ASSERT(0);
     }
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
-
-    printf("=====================================================\r\n"
-           "Connected Sensor Kit: PAS CO2 Application on FreeRTOS\r\n"
-           "=====================================================\r\n");
-
-    printf("For more PSoC 6 MCU projects, "
-           "visit our code examples repositories:\r\n\r\n");
-
-    printf("https://github.com/cypresssemiconductorco/\r\n\r\n"
-           "Code-Examples-for-ModusToolbox-Software\r\n\r\n");
+    /* Create the mutex which serializes the terminal output of the tasks */
+    result = pasco2_print_init();
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
 
-    /* Create PAS CO2 task */
-    cy_thread_t ifx_pasco2_task;
-    result = cy_rtos_create_thread(&ifx_pasco2_task,
-                                   pasco2_task,
-                                   PASCO2_TASK_NAME,
+    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+    pasco2_printf("\x1b[2J\x1b[;H");
+
+    pasco2_printf("=====================================================\r\n"
+                  "Connected Sensor Kit: PAS CO2 Application on FreeRTOS\r\n"
+                  "=====================================================\r\n");
+
+    pasco2_printf("For more PSoC 6 MCU projects, "
+                  "visit our code examples repositories:\r\n\r\n");
+
+    pasco2_printf("https://github.com/cypresssemiconductorco/\r\n\r\n"
+                  "Code-Examples-for-ModusToolbox-Software\r\n\r\n");
+
+    /* Report the reset cause and the state saved before the last reset */
+    pasco2_health_init();
+
+#if defined(PASCO2_TRACE_ENABLED)
+    /* Start kernel event tracing before the tasks are created */
+    pasco2_trace_init();
+#endif
+
+    /* Add the PAS CO2 sensor and terminal UI jobs and create the task which
+     * runs them on a single stack */
+    pasco2_task_init();
+    pasco2_terminal_ui_init();
+    cy_thread_t ifx_pasco2_executor_task;
+    result = cy_rtos_create_thread(&ifx_pasco2_executor_task,
+                                   pasco2_executor_task,
+                                   PASCO2_EXECUTOR_TASK_NAME,
                                    NULL,
-                                   PASCO2_TASK_STACK_SIZE,
-                                   PASCO2_TASK_PRIORITY,
+                                   PASCO2_EXECUTOR_TASK_STACK_SIZE,
+                                   PASCO2_EXECUTOR_TASK_PRIORITY,
                                    (cy_thread_arg_t)NULL);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
 
-    /* Create PAS CO2 terminal UI task */
-    cy_thread_t ifx_pasco2_terminal_task;
-    result = cy_rtos_create_thread(&ifx_pasco2_terminal_task,
-                                   pasco2_terminal_ui_task,
-                                   PASCO2_TERMINAL_UI_TASK_NAME,
+    /* Create task health monitor */
+    cy_thread_t ifx_pasco2_health_task;
+    result = cy_rtos_create_thread(&ifx_pasco2_health_task,
+                                   pasco2_health_task,
+                                   PASCO2_HEALTH_TASK_NAME,
                                    NULL,
-                                   PASCO2_TERMINAL_UI_TASK_STACK_SIZE,
-                                   PASCO2_TERMINAL_UI_TASK_PRIORITY,
+                                   PASCO2_HEALTH_TASK_STACK_SIZE,
+                                   PASCO2_HEALTH_TASK_PRIORITY,
                                    (cy_thread_arg_t)NULL);
     if (result != CY_RSLT_SUCCESS)
     {
@@ -0,0 +1,151 @@
+/*****************************************************************************
+** File name: pasco2_adaptive_period.c
+**
+** Description: This file implements a closed-loop controller that adapts the
+** measurement period of the CO2 sensor to the rate of change of the CO2 value.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stddef.h>
+
+/* Header file for local module */
+#include "pasco2_adaptive_period.h"
+
+/*******************************************************************************
+ * Function Name: pasco2_adaptive_period_default_config
+ *******************************************************************************
+ * Summary:
+ *   Fills a controller configuration with the compile-time defaults.
+ *
+ * Parameters:
+ *   config: configuration to be filled
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_adaptive_period_default_config(pasco2_adaptive_period_config_t *config)
+{
+    config->min_period = PASCO2_ADAPTIVE_PERIOD_MIN;
+    config->max_period = PASCO2_ADAPTIVE_PERIOD_MAX;
+    config->rate_fast = PASCO2_ADAPTIVE_RATE_FAST;
+    config->rate_slow = PASCO2_ADAPTIVE_RATE_SLOW;
+    config->stable_samples = PASCO2_ADAPTIVE_STABLE_SAMPLES;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_adaptive_period_init
+ *******************************************************************************
+ * Summary:
+ *   Resets the controller. The initial period is clamped to the configured
+ *   bounds.
+ *
+ * Parameters:
+ *   ctrl: controller object
+ *   config: controller configuration, NULL selects the defaults
+ *   initial_period: measurement period in s to start with
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_adaptive_period_init(pasco2_adaptive_period_t *ctrl,
+                                 const pasco2_adaptive_period_config_t *config,
+                                 uint16_t initial_period)
+{
+    if (config != NULL)
+    {
+        ctrl->config = *config;
+    }
+    else
+    {
+        pasco2_adaptive_period_default_config(&ctrl->config);
+    }
+
+    if (initial_period < ctrl->config.min_period)
+    {
+        initial_period = ctrl->config.min_period;
+    }
+    else if (initial_period > ctrl->config.max_period)
+    {
+        initial_period = ctrl->config.max_period;
+    }
+
+    ctrl->period = initial_period;
+    ctrl->last_ppm = 0;
+    ctrl->rate = 0;
+    ctrl->stable_count = 0;
+    ctrl->has_sample = false;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_adaptive_period_update
+ *******************************************************************************
+ * Summary:
+ *   Feeds a new CO2 value into the controller. The rate of change is
+ *   estimated from the previous value and smoothed. A fast change selects
+ *   the shortest period, a stable reading over several samples stretches it
+ *   by 50%. Rates between rate_slow and rate_fast keep the current period
+ *   (hysteresis band).
+ *
+ * Parameters:
+ *   ctrl: controller object
+ *   ppm: new CO2 value
+ *   elapsed_ms: time since the previous CO2 value in ms
+ *
+ * Return:
+ *   measurement period in s to be used from now on
+ *******************************************************************************/
+uint16_t pasco2_adaptive_period_update(pasco2_adaptive_period_t *ctrl, uint16_t ppm, uint32_t elapsed_ms)
+{
+    if (!ctrl->has_sample || (elapsed_ms == 0U))
+    {
+        ctrl->last_ppm = ppm;
+        ctrl->has_sample = true;
+        return ctrl->period;
+    }
+
+    int32_t rate = (((int32_t)ppm - (int32_t)ctrl->last_ppm) * 60000) / (int32_t)elapsed_ms;
+    ctrl->rate = (ctrl->rate + rate) / 2;
+    ctrl->last_ppm = ppm;
+
+    uint32_t abs_rate = (uint32_t)((ctrl->rate < 0) ? -ctrl->rate : ctrl->rate);
+    if (abs_rate >= ctrl->config.rate_fast)
+    {
+        /* CO2 is changing quickly, sample as fast as allowed at once */
+        ctrl->period = ctrl->config.min_period;
+        ctrl->stable_count = 0;
+    }
+    else if (abs_rate < ctrl->config.rate_slow)
+    {
+        /* CO2 is stable, stretch the period once enough samples agree */
+        if (++ctrl->stable_count >= ctrl->config.stable_samples)
+        {
+            uint32_t period = (uint32_t)ctrl->period + (ctrl->period / 2U) + 1U;
+            ctrl->period = (period > ctrl->config.max_period) ? ctrl->config.max_period : (uint16_t)period;
+            ctrl->stable_count = 0;
+        }
+    }
+    else
+    {
+        ctrl->stable_count = 0;
+    }
+
+    return ctrl->period;
+}
@@ -0,0 +1,74 @@
+/******************************************************************************
+** File name: pasco2_adaptive_period.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_adaptive_period.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Shortest measurement period the controller selects, in seconds */
+#define PASCO2_ADAPTIVE_PERIOD_MIN (10U)
+/* Longest measurement period the controller selects, in seconds */
+#define PASCO2_ADAPTIVE_PERIOD_MAX (300U)
+/* CO2 rate of change in ppm/min above which the period is shortened */
+#define PASCO2_ADAPTIVE_RATE_FAST (15U)
+/* CO2 rate of change in ppm/min below which the reading counts as stable */
+#define PASCO2_ADAPTIVE_RATE_SLOW (10U)
+/* Number of consecutive stable samples before the period is stretched */
+#define PASCO2_ADAPTIVE_STABLE_SAMPLES (3U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint16_t min_period;    /* lower bound of the measurement period in s */
+    uint16_t max_period;    /* upper bound of the measurement period in s */
+    uint16_t rate_fast;     /* ppm/min which triggers a shorter period */
+    uint16_t rate_slow;     /* ppm/min below which the reading is stable */
+    uint8_t stable_samples; /* stable samples required to stretch the period */
+} pasco2_adaptive_period_config_t;
+
+typedef struct
+{
+    pasco2_adaptive_period_config_t config;
+    uint16_t period;      /* currently requested measurement period in s */
+    uint16_t last_ppm;    /* previous CO2 value */
+    int32_t rate;         /* filtered rate of change in ppm/min */
+    uint8_t stable_count; /* consecutive samples below rate_slow */
+    bool has_sample;      /* last_ppm holds a valid value */
+} pasco2_adaptive_period_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_adaptive_period_default_config(pasco2_adaptive_period_config_t *config);
+void pasco2_adaptive_period_init(pasco2_adaptive_period_t *ctrl,
+                                 const pasco2_adaptive_period_config_t *config,
+                                 uint16_t initial_period);
+uint16_t pasco2_adaptive_period_update(pasco2_adaptive_period_t *ctrl, uint16_t ppm, uint32_t elapsed_ms);
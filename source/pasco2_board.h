@@ -0,0 +1,171 @@
+/******************************************************************************
+** File name: pasco2_board.h
+**
+** Description: This file describes the hardware variants the application can
+**   be built for: pins, I2C bus, sensor limits, and the stacks and priorities
+**   of the tasks. The variant is selected at compile time and validated with
+**   static assertions.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <assert.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cybsp.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "pasco2_adaptive_period.h"
+
+/*******************************************************************************
+ * Board variants
+ *******************************************************************************/
+/* CYSBSYSKIT-DEV-01 with the PAS CO2 Wing Board */
+#define PASCO2_BOARD_WING_BOARD (1)
+/* CYSBSYSKIT-DEV-01 with a PAS CO2 sensor module wired to its I2C bus. The
+ * module is powered and set to I2C mode by hardware and has no LEDs; the
+ * user LED of the kit shows the initialization. */
+#define PASCO2_BOARD_SENSOR_MODULE (2)
+
+/* Selected variant, can be set with PASCO2_BOARD in DEFINES of the Makefile */
+#if !defined(PASCO2_BOARD)
+#define PASCO2_BOARD PASCO2_BOARD_WING_BOARD
+#endif
+
+/* Every variant defines all of the following pins. Pins which are not
+ * connected on a variant are set to NC; the code using them is then removed
+ * by the compiler. */
+#if (PASCO2_BOARD == PASCO2_BOARD_WING_BOARD)
+
+/* I2C bus of the sensor */
+#define MTB_PASCO2_I2C_SDA (CYBSP_I2C_SDA)
+#define MTB_PASCO2_I2C_SCL (CYBSP_I2C_SCL)
+/* I2C bus frequency */
+#define I2C_MASTER_FREQUENCY (100000U)
+
+/* Output pin for sensor PSEL line */
+#define MTB_PASCO2_PSEL (P5_3)
+/* Pin state to enable I2C channel of sensor */
+#define MTB_PASCO2_PSEL_I2C_ENABLE (0U)
+/* Output pin for PAS CO2 Wing Board power switch */
+#define MTB_PASCO2_POWER_SWITCH (P10_5)
+/* Pin state to enable power to sensor on PAS CO2 Wing Board*/
+#define MTB_PASCO2_POWER_ON (1U)
+
+/* Output pin for the initialization LED and its pin states */
+#define MTB_PASCO2_LED_INIT           (CYBSP_USER_LED)
+#define MTB_PASCO2_LED_INIT_STATE_ON  (CYBSP_LED_STATE_ON)
+#define MTB_PASCO2_LED_INIT_STATE_OFF (CYBSP_LED_STATE_OFF)
+/* Output pin for PAS CO2 Wing Board LED OK */
+#define MTB_PASCO2_LED_OK (P9_0)
+/* Output pin for PAS CO2 Wing Board LED WARNING  */
+#define MTB_PASCO2_LED_WARNING (P9_1)
+
+/* Pin state for PAS CO2 Wing Board LED off. */
+#define MTB_PASCO_LED_STATE_OFF (0U)
+/* Pin state for PAS CO2 Wing Board LED on. */
+#define MTB_PASCO_LED_STATE_ON (1U)
+
+#elif (PASCO2_BOARD == PASCO2_BOARD_SENSOR_MODULE)
+
+/* I2C bus of the sensor */
+#define MTB_PASCO2_I2C_SDA (CYBSP_I2C_SDA)
+#define MTB_PASCO2_I2C_SCL (CYBSP_I2C_SCL)
+/* I2C bus frequency */
+#define I2C_MASTER_FREQUENCY (400000U)
+
+/* PSEL is tied to ground and the module is always powered */
+#define MTB_PASCO2_PSEL            (NC)
+#define MTB_PASCO2_PSEL_I2C_ENABLE (0U)
+#define MTB_PASCO2_POWER_SWITCH    (NC)
+#define MTB_PASCO2_POWER_ON        (1U)
+
+/* Output pin for the initialization LED and its pin states */
+#define MTB_PASCO2_LED_INIT           (CYBSP_USER_LED)
+#define MTB_PASCO2_LED_INIT_STATE_ON  (CYBSP_LED_STATE_ON)
+#define MTB_PASCO2_LED_INIT_STATE_OFF (CYBSP_LED_STATE_OFF)
+/* The module has no status LEDs */
+#define MTB_PASCO2_LED_OK       (NC)
+#define MTB_PASCO2_LED_WARNING  (NC)
+#define MTB_PASCO_LED_STATE_OFF (0U)
+#define MTB_PASCO_LED_STATE_ON  (1U)
+
+#else
+#error "Unsupported PASCO2_BOARD variant"
+#endif
+
+/*******************************************************************************
+ * Sensor limits
+ *******************************************************************************/
+/* Measurement period range of the PAS CO2 sensor in s */
+#define PASCO2_SENSOR_PERIOD_MIN (10U)
+#define PASCO2_SENSOR_PERIOD_MAX (4095U)
+/* Maximum I2C bus frequency of the PAS CO2 sensor */
+#define PASCO2_SENSOR_I2C_FREQUENCY_MAX (400000U)
+
+/*******************************************************************************
+ * Tasks
+ *******************************************************************************/
+/* Stacks and priorities of the tasks, a variant can define other values
+ * before this point. The executor runs all application jobs on one stack. */
+#if !defined(PASCO2_EXECUTOR_TASK_STACK_SIZE)
+#define PASCO2_EXECUTOR_TASK_STACK_SIZE (1024 * 2)
+#endif
+#if !defined(PASCO2_EXECUTOR_TASK_PRIORITY)
+#define PASCO2_EXECUTOR_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
+#endif
+#if !defined(PASCO2_HEALTH_TASK_STACK_SIZE)
+#define PASCO2_HEALTH_TASK_STACK_SIZE (1024)
+#endif
+#if !defined(PASCO2_HEALTH_TASK_PRIORITY)
+#define PASCO2_HEALTH_TASK_PRIORITY (CY_RTOS_PRIORITY_NORMAL)
+#endif
+
+/*******************************************************************************
+ * Validation
+ *******************************************************************************/
+/* Number of functions a pin is used for */
+#define PASCO2_BOARD_PIN_USES(pin)                                                                                     \
+    (((pin) == MTB_PASCO2_I2C_SDA) + ((pin) == MTB_PASCO2_I2C_SCL) + ((pin) == MTB_PASCO2_PSEL) +                      \
+     ((pin) == MTB_PASCO2_POWER_SWITCH) + ((pin) == MTB_PASCO2_LED_INIT) + ((pin) == MTB_PASCO2_LED_OK) +              \
+     ((pin) == MTB_PASCO2_LED_WARNING))
+/* A connected pin must not be used for more than one function */
+#define PASCO2_BOARD_PIN_UNIQUE(pin) (((pin) == NC) || (PASCO2_BOARD_PIN_USES(pin) == 1))
+
+static_assert((MTB_PASCO2_I2C_SDA != NC) && (MTB_PASCO2_I2C_SCL != NC), "the sensor I2C bus must be connected");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_I2C_SDA), "MTB_PASCO2_I2C_SDA is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_I2C_SCL), "MTB_PASCO2_I2C_SCL is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_PSEL), "MTB_PASCO2_PSEL is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_POWER_SWITCH), "MTB_PASCO2_POWER_SWITCH is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_LED_INIT), "MTB_PASCO2_LED_INIT is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_LED_OK), "MTB_PASCO2_LED_OK is used twice");
+static_assert(PASCO2_BOARD_PIN_UNIQUE(MTB_PASCO2_LED_WARNING), "MTB_PASCO2_LED_WARNING is used twice");
+static_assert((I2C_MASTER_FREQUENCY > 0U) && (I2C_MASTER_FREQUENCY <= PASCO2_SENSOR_I2C_FREQUENCY_MAX),
+              "I2C_MASTER_FREQUENCY exceeds the sensor limit");
+static_assert((PASCO2_ADAPTIVE_PERIOD_MIN >= PASCO2_SENSOR_PERIOD_MIN) &&
+                  (PASCO2_ADAPTIVE_PERIOD_MAX <= PASCO2_SENSOR_PERIOD_MAX),
+              "adaptive period bounds exceed the sensor measurement period range");
+
+/* The health monitor has to run while a job keeps the executor busy */
+static_assert(PASCO2_HEALTH_TASK_PRIORITY > PASCO2_EXECUTOR_TASK_PRIORITY,
+              "the health monitor must preempt the executor");
@@ -0,0 +1,302 @@
+/*****************************************************************************
+** File name: pasco2_config_store.c
+**
+** Description: This file implements a persistent store for the application
+** configuration in emulated EEPROM.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cy_em_eeprom.h"
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "pasco2_config_store.h"
+
+/* Marks a configuration record ("PCFG") */
+#define CONFIG_STORE_MAGIC (0x47464350UL)
+
+/* Emulated EEPROM parameters. Rows are written with the non-blocking flash
+ * API, so that interrupts and the health monitor keep running while the
+ * executor writes the configuration. */
+#define CONFIG_STORE_EEPROM_SIZE      (64U)
+#define CONFIG_STORE_SIMPLE_MODE      (0U)
+#define CONFIG_STORE_WEAR_LEVELING    (2U)
+#define CONFIG_STORE_REDUNDANT_COPY   (1U)
+#define CONFIG_STORE_BLOCKING_WRITE   (0U)
+#define CONFIG_STORE_RECORD_ADDRESS   (0U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length; /* size of data */
+    pasco2_config_store_data_t data;
+    uint32_t crc; /* CRC-32 of all preceding fields */
+} config_store_record_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+/* Emulated EEPROM storage in the auxiliary flash */
+CY_SECTION(".cy_em_eeprom")
+CY_ALIGN(CY_EM_EEPROM_FLASH_SIZEOF_ROW)
+static const uint8_t config_store_flash[CY_EM_EEPROM_GET_PHYSICAL_SIZE(CONFIG_STORE_EEPROM_SIZE,
+                                                                       CONFIG_STORE_SIMPLE_MODE,
+                                                                       CONFIG_STORE_WEAR_LEVELING,
+                                                                       CONFIG_STORE_REDUNDANT_COPY)] = {0U};
+
+static cy_stc_eeprom_config_t config_store_eeprom_config = {
+    .eepromSize = CONFIG_STORE_EEPROM_SIZE,
+    .simpleMode = CONFIG_STORE_SIMPLE_MODE,
+    .blockingWrite = CONFIG_STORE_BLOCKING_WRITE,
+    .redundantCopy = CONFIG_STORE_REDUNDANT_COPY,
+    .wearLevelingFactor = CONFIG_STORE_WEAR_LEVELING,
+};
+static cy_stc_eeprom_context_t config_store_eeprom_context;
+
+/* Configuration in flash, the pending configuration and its state */
+static pasco2_config_store_data_t config_stored;
+static pasco2_config_store_data_t config_pending;
+static bool config_valid = false;
+static bool config_dirty = false;
+static cy_time_t config_changed_time;
+
+static_assert(sizeof(config_store_record_t) <= CONFIG_STORE_EEPROM_SIZE, "config record exceeds the EEPROM size");
+
+/*******************************************************************************
+ * Function Name: config_store_crc32
+ *******************************************************************************
+ * Summary:
+ *   Calculates the CRC-32 (IEEE 802.3) of a buffer.
+ *
+ * Parameters:
+ *   data: buffer
+ *   length: number of bytes
+ *
+ * Return:
+ *   CRC-32 value
+ *******************************************************************************/
+static uint32_t config_store_crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    while (length-- > 0U)
+    {
+        crc ^= *data++;
+        for (uint32_t bit = 0; bit < 8U; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320UL : 0U);
+        }
+    }
+    return ~crc;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_config_store_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the emulated EEPROM and loads the configuration record.
+ *   Records with a wrong magic value, version, length or CRC are ignored.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the emulated EEPROM initialization
+ *******************************************************************************/
+cy_rslt_t pasco2_config_store_init(void)
+{
+    config_store_eeprom_config.userFlashStartAddr = (uint32_t)(uintptr_t)config_store_flash;
+    if (Cy_Em_EEPROM_Init(&config_store_eeprom_config, &config_store_eeprom_context) != CY_EM_EEPROM_SUCCESS)
+    {
+        return PASCO2_CONFIG_STORE_RSLT_ERR_EEPROM;
+    }
+
+    config_store_record_t record;
+    if (Cy_Em_EEPROM_Read(CONFIG_STORE_RECORD_ADDRESS, &record, sizeof(record), &config_store_eeprom_context) !=
+        CY_EM_EEPROM_SUCCESS)
+    {
+        return PASCO2_CONFIG_STORE_RSLT_ERR_EEPROM;
+    }
+
+    config_valid = (record.magic == CONFIG_STORE_MAGIC) && (record.version == PASCO2_CONFIG_STORE_VERSION) &&
+                   (record.length == sizeof(record.data)) &&
+                   (record.crc == config_store_crc32((const uint8_t *)&record, offsetof(config_store_record_t, crc)));
+    if (config_valid)
+    {
+        config_stored = record.data;
+    }
+    else
+    {
+        memset(&config_stored, 0, sizeof(config_stored));
+    }
+    config_pending = config_stored;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_config_store_get
+ *******************************************************************************
+ * Summary:
+ *   Returns the configuration restored from flash.
+ *
+ * Parameters:
+ *   data: restored configuration
+ *
+ * Return:
+ *   true if a valid record was found
+ *******************************************************************************/
+bool pasco2_config_store_get(pasco2_config_store_data_t *data)
+{
+    *data = config_stored;
+    return config_valid;
+}
+
+/*******************************************************************************
+ * Function Name: config_store_changed
+ *******************************************************************************
+ * Summary:
+ *   Restarts the commit delay after a change of the pending configuration.
+ *   Has to be called inside a critical section.
+ *
+ * Parameters:
+ *   now: current time in ms
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void config_store_changed(cy_time_t now)
+{
+    config_changed_time = now;
+    config_dirty = true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_config_store_set_measurement_period
+ *******************************************************************************
+ * Summary:
+ *   Updates the measurement period of the pending configuration. The change
+ *   is written by pasco2_config_store_process.
+ *
+ * Parameters:
+ *   measurement_period: measurement period in s
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_config_store_set_measurement_period(uint16_t measurement_period)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    config_pending.measurement_period = measurement_period;
+    config_store_changed(now);
+    cyhal_system_critical_section_exit(critical_section);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_config_store_set_adaptive_period
+ *******************************************************************************
+ * Summary:
+ *   Updates the adaptive period flag of the pending configuration. The change
+ *   is written by pasco2_config_store_process.
+ *
+ * Parameters:
+ *   adaptive_period: adaptive measurement period enabled
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_config_store_set_adaptive_period(bool adaptive_period)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    config_pending.adaptive_period = adaptive_period ? 1U : 0U;
+    config_store_changed(now);
+    cyhal_system_critical_section_exit(critical_section);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_config_store_process
+ *******************************************************************************
+ * Summary:
+ *   Writes the pending configuration once it has not changed for
+ *   PASCO2_CONFIG_STORE_COMMIT_DELAY. Nothing is written if the pending
+ *   configuration equals the record in flash. Has to be called periodically.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_config_store_process(void)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    bool commit = config_dirty && ((uint32_t)(now - config_changed_time) >= PASCO2_CONFIG_STORE_COMMIT_DELAY);
+    config_store_record_t record = {
+        .magic = CONFIG_STORE_MAGIC,
+        .version = PASCO2_CONFIG_STORE_VERSION,
+        .length = sizeof(record.data),
+        .data = config_pending,
+    };
+    if (commit)
+    {
+        config_dirty = false;
+    }
+    cyhal_system_critical_section_exit(critical_section);
+
+    if (!commit || (config_valid && (memcmp(&record.data, &config_stored, sizeof(config_stored)) == 0)))
+    {
+        return;
+    }
+
+    record.crc = config_store_crc32((const uint8_t *)&record, offsetof(config_store_record_t, crc));
+    if (Cy_Em_EEPROM_Write(CONFIG_STORE_RECORD_ADDRESS, &record, sizeof(record), &config_store_eeprom_context) ==
+        CY_EM_EEPROM_SUCCESS)
+    {
+        config_stored = record.data;
+        config_valid = true;
+    }
+    else
+    {
+        /* Retry after the next commit delay */
+        critical_section = cyhal_system_critical_section_enter();
+        config_store_changed(now);
+        cyhal_system_critical_section_exit(critical_section);
+    }
+}
@@ -0,0 +1,62 @@
+/******************************************************************************
+** File name: pasco2_config_store.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_config_store.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Time in ms without further changes before the configuration is written to
+ * flash, coalesces repeated edits into a single write */
+#define PASCO2_CONFIG_STORE_COMMIT_DELAY (10000U)
+/* Version of the stored record, records of other versions are ignored */
+#define PASCO2_CONFIG_STORE_VERSION (1U)
+/* The emulated EEPROM could not be initialized or read */
+#define PASCO2_CONFIG_STORE_RSLT_ERR_EEPROM (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint16_t measurement_period; /* measurement period in s, 0 if never set */
+    uint8_t adaptive_period;     /* adaptive measurement period enabled */
+    uint8_t reserved;
+} pasco2_config_store_data_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t pasco2_config_store_init(void);
+bool pasco2_config_store_get(pasco2_config_store_data_t *data);
+void pasco2_config_store_set_measurement_period(uint16_t measurement_period);
+void pasco2_config_store_set_adaptive_period(bool adaptive_period);
+void pasco2_config_store_process(void);
@@ -0,0 +1,316 @@
+/*****************************************************************************
+** File name: pasco2_executor.c
+**
+** Description: This file implements a cooperative executor which runs all
+** application jobs on a single task stack. Jobs are state machines which are
+** resumed by their timer or by events signalled from other jobs or
+** interrupts.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "FreeRTOS.h"
+#include "cyhal.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "pasco2_executor.h"
+#include "pasco2_health.h"
+#include "pasco2_print.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+static pasco2_job_t *executor_jobs = NULL;
+static cy_semaphore_t executor_wakeup;
+static volatile bool executor_started = false;
+/* Smallest free stack of the executor task in bytes */
+static uint32_t executor_stack_free = 0;
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a job to the executor. The job is started with
+ *   PASCO2_EXECUTOR_EVENT_START when the executor task runs. Jobs run in the
+ *   order in which they were added. Has to be called before the scheduler is
+ *   started.
+ *
+ * Parameters:
+ *   job: job with name and handler set
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_add(pasco2_job_t *job)
+{
+    job->state = 0;
+    job->events = PASCO2_EXECUTOR_EVENT_START;
+    job->timer_armed = false;
+    job->next = NULL;
+
+    pasco2_job_t **tail = &executor_jobs;
+    while (*tail != NULL)
+    {
+        tail = &(*tail)->next;
+    }
+    *tail = job;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_schedule
+ *******************************************************************************
+ * Summary:
+ *   Arms the timer of a job, replacing a timer which is still armed. The job
+ *   is resumed with PASCO2_EXECUTOR_EVENT_TIMER once the delay has elapsed.
+ *   Has to be called from a job.
+ *
+ * Parameters:
+ *   job: job to resume
+ *   delay_ms: delay in ms, 0 resumes the job in the next executor cycle
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_schedule(pasco2_job_t *job, uint32_t delay_ms)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+    job->wakeup = now + delay_ms;
+    job->timer_armed = true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_signal
+ *******************************************************************************
+ * Summary:
+ *   Signals events to a job and wakes up the executor. Has to be called from
+ *   task context.
+ *
+ * Parameters:
+ *   job: job to resume
+ *   events: job defined event bits
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_signal(pasco2_job_t *job, uint32_t events)
+{
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    job->events |= events;
+    cyhal_system_critical_section_exit(critical_section);
+
+    if (executor_started)
+    {
+        cy_rtos_set_semaphore(&executor_wakeup, false);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_signal_from_isr
+ *******************************************************************************
+ * Summary:
+ *   Signals events to a job and wakes up the executor from an interrupt
+ *   handler.
+ *
+ * Parameters:
+ *   job: job to resume
+ *   events: job defined event bits
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_signal_from_isr(pasco2_job_t *job, uint32_t events)
+{
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    job->events |= events;
+    cyhal_system_critical_section_exit(critical_section);
+
+    if (executor_started)
+    {
+        cy_rtos_set_semaphore(&executor_wakeup, true);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: executor_run_jobs
+ *******************************************************************************
+ * Summary:
+ *   Runs every job with pending events or an expired timer once.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void executor_run_jobs(void)
+{
+    for (pasco2_job_t *job = executor_jobs; job != NULL; job = job->next)
+    {
+        cy_time_t start;
+        cy_rtos_get_time(&start);
+
+        uint32_t critical_section = cyhal_system_critical_section_enter();
+        uint32_t events = job->events;
+        job->events = 0;
+        cyhal_system_critical_section_exit(critical_section);
+
+        if (job->timer_armed && ((int32_t)(start - job->wakeup) >= 0))
+        {
+            job->timer_armed = false;
+            events |= PASCO2_EXECUTOR_EVENT_TIMER;
+        }
+        if (events == 0U)
+        {
+            continue;
+        }
+
+        job->handler(job, events);
+
+        cy_time_t end;
+        cy_rtos_get_time(&end);
+        job->runs++;
+        if ((uint32_t)(end - start) > job->max_run)
+        {
+            job->max_run = (uint32_t)(end - start);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: executor_idle_time
+ *******************************************************************************
+ * Summary:
+ *   Returns the time until the next job has to run.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   time in ms, at most PASCO2_EXECUTOR_MAX_IDLE
+ *******************************************************************************/
+static uint32_t executor_idle_time(void)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t idle = PASCO2_EXECUTOR_MAX_IDLE;
+    for (pasco2_job_t *job = executor_jobs; job != NULL; job = job->next)
+    {
+        if (job->events != 0U)
+        {
+            return 0U;
+        }
+        if (job->timer_armed)
+        {
+            int32_t remaining = (int32_t)(job->wakeup - now);
+            if (remaining <= 0)
+            {
+                return 0U;
+            }
+            if ((uint32_t)remaining < idle)
+            {
+                idle = (uint32_t)remaining;
+            }
+        }
+    }
+    return idle;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_run
+ *******************************************************************************
+ * Summary:
+ *   Runs one executor cycle: every job with pending events or an expired
+ *   timer runs once.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   time in ms until the next job has to run, at most
+ *   PASCO2_EXECUTOR_MAX_IDLE
+ *******************************************************************************/
+uint32_t pasco2_executor_run(void)
+{
+    executor_run_jobs();
+    return executor_idle_time();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_task
+ *******************************************************************************
+ * Summary:
+ *   Runs the jobs until none of them has pending work and sleeps until the
+ *   next job timer expires or an event is signalled. Reports a heartbeat to
+ *   the health monitor and records the stack usage in every cycle.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_task(cy_thread_arg_t arg)
+{
+    cy_rslt_t result = cy_rtos_init_semaphore(&executor_wakeup, 1U, 0U);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    executor_started = true;
+
+    for (;;)
+    {
+        uint32_t idle = pasco2_executor_run();
+        pasco2_health_heartbeat(PASCO2_HEALTH_EXECUTOR, idle);
+        executor_stack_free = (uint32_t)uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+        if (idle > 0U)
+        {
+            /* Returns early when an event is signalled */
+            cy_rtos_get_semaphore(&executor_wakeup, idle, false);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_executor_print_statistics
+ *******************************************************************************
+ * Summary:
+ *   Prints the number of runs and the longest run time of every job and the
+ *   free stack of the executor.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_executor_print_statistics(void)
+{
+    pasco2_printf("%-12s %10s %8s\r\n", "Job", "Runs", "Max ms");
+    for (pasco2_job_t *job = executor_jobs; job != NULL; job = job->next)
+    {
+        pasco2_printf("%-12s %10u %8u\r\n", job->name, (unsigned int)job->runs, (unsigned int)job->max_run);
+    }
+    pasco2_printf("Executor: %u bytes of stack never used\r\n\r\n", (unsigned int)executor_stack_free);
+}
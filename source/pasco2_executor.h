@@ -0,0 +1,80 @@
+/******************************************************************************
+** File name: pasco2_executor.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_executor.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Name of the executor task which runs all application jobs, its stack and
+ * priority are set in pasco2_board.h */
+#define PASCO2_EXECUTOR_TASK_NAME "PASCO2 EXECUTOR"
+/* Maximum time in ms the executor sleeps before it reports a heartbeat */
+#define PASCO2_EXECUTOR_MAX_IDLE (1000U)
+
+/* Events passed to a job handler, bits from PASCO2_EXECUTOR_EVENT_USER are
+ * defined by the job */
+#define PASCO2_EXECUTOR_EVENT_START (1UL << 0) /* first run after the executor started */
+#define PASCO2_EXECUTOR_EVENT_TIMER (1UL << 1) /* the job timer expired */
+#define PASCO2_EXECUTOR_EVENT_USER  (1UL << 2)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct pasco2_job pasco2_job_t;
+
+/* Runs a job until it has to wait for a timer or an event. The job keeps its
+ * position in state and must not block. */
+typedef void (*pasco2_job_handler_t)(pasco2_job_t *job, uint32_t events);
+
+struct pasco2_job
+{
+    const char *name;
+    pasco2_job_handler_t handler;
+    uint32_t state;           /* resume point, defined by the job */
+    volatile uint32_t events; /* pending events */
+    bool timer_armed;
+    cy_time_t wakeup; /* expiry time of the job timer in ms */
+    uint32_t runs;    /* number of handler calls */
+    uint32_t max_run; /* longest handler call in ms */
+    pasco2_job_t *next;
+};
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_executor_add(pasco2_job_t *job);
+void pasco2_executor_schedule(pasco2_job_t *job, uint32_t delay_ms);
+void pasco2_executor_signal(pasco2_job_t *job, uint32_t events);
+void pasco2_executor_signal_from_isr(pasco2_job_t *job, uint32_t events);
+uint32_t pasco2_executor_run(void);
+void pasco2_executor_task(cy_thread_arg_t arg);
+void pasco2_executor_print_statistics(void);
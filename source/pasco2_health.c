@@ -0,0 +1,322 @@
+/*****************************************************************************
+** File name: pasco2_health.c
+**
+** Description: This file implements a supervisor which checks the heartbeats
+** of the application tasks against their loop deadlines and only feeds the
+** hardware watchdog while all tasks are healthy.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "pasco2_health.h"
+#include "pasco2_print.h"
+
+/* Marks a valid snapshot in retained RAM ("HLTH") */
+#define HEALTH_SNAPSHOT_MAGIC (0x48544C48UL)
+/* No task failed */
+#define HEALTH_TASK_NONE (0xFFU)
+/* Deadline in ms until the first heartbeat, covers the sensor power-up */
+#define HEALTH_STARTUP_DEADLINE (10000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint32_t last_heartbeat; /* time of the last heartbeat in ms */
+    uint32_t deadline;       /* announced time until the next heartbeat in ms */
+    uint32_t last_loop;      /* duration of the last loop in ms */
+    uint32_t max_loop;       /* longest loop in ms */
+    uint32_t misses;         /* loops longer than deadline plus margin */
+    uint32_t histogram[PASCO2_HEALTH_HISTOGRAM_BUCKETS];
+} health_task_state_t;
+
+/* Post-mortem information which survives a reset */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t boot_count;
+    uint32_t watchdog_resets;
+    uint32_t reset_reason; /* cyhal_reset_reason_t of the current boot */
+    uint32_t uptime;       /* uptime in ms at the last check */
+    uint32_t failed_task;  /* pasco2_health_task_t which stopped the watchdog feed */
+    uint32_t failed_task_age;
+    uint32_t failed_task_deadline;
+} health_snapshot_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+/* Upper limits of the loop time histogram buckets in percent of the announced
+ * deadline, the last bucket collects everything above */
+static const uint32_t histogram_limits[PASCO2_HEALTH_HISTOGRAM_BUCKETS - 1U] = {100U, 110U, 125U, 150U, 200U};
+
+static health_task_state_t health_tasks[PASCO2_HEALTH_TASK_COUNT] = {
+    [PASCO2_HEALTH_SENSOR_JOB] = {.name = "CO2 sensor", .deadline = HEALTH_STARTUP_DEADLINE},
+    [PASCO2_HEALTH_EXECUTOR] = {.name = "executor", .deadline = HEALTH_STARTUP_DEADLINE},
+};
+
+/* Snapshot in retained RAM and its copy from before the last reset */
+CY_NOINIT static health_snapshot_t health_snapshot;
+static health_snapshot_t health_previous;
+
+static cyhal_wdt_t health_wdt;
+
+/*******************************************************************************
+ * Function Name: pasco2_health_init
+ *******************************************************************************
+ * Summary:
+ *   Saves the snapshot of the previous run and the reset cause. Has to be
+ *   called once from main before the scheduler is started.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_health_init(void)
+{
+    uint32_t reset_reason = cyhal_system_get_reset_reason();
+    cyhal_system_clear_reset_reason();
+
+    if (health_snapshot.magic != HEALTH_SNAPSHOT_MAGIC)
+    {
+        /* Power-on, the retained RAM content is random */
+        health_snapshot.magic = HEALTH_SNAPSHOT_MAGIC;
+        health_snapshot.boot_count = 0;
+        health_snapshot.watchdog_resets = 0;
+        health_snapshot.uptime = 0;
+        health_snapshot.failed_task = HEALTH_TASK_NONE;
+    }
+    health_previous = health_snapshot;
+
+    health_snapshot.boot_count++;
+    if ((reset_reason & CYHAL_SYSTEM_RESET_WDT) != 0U)
+    {
+        health_snapshot.watchdog_resets++;
+    }
+    health_snapshot.reset_reason = reset_reason;
+    health_snapshot.uptime = 0;
+    health_snapshot.failed_task = HEALTH_TASK_NONE;
+    health_snapshot.failed_task_age = 0;
+    health_snapshot.failed_task_deadline = 0;
+
+    if (((reset_reason & CYHAL_SYSTEM_RESET_WDT) != 0U) && (health_previous.failed_task < PASCO2_HEALTH_TASK_COUNT))
+    {
+        pasco2_printf("Watchdog reset: %s task missed its deadline (%u ms late heartbeat, deadline %u ms)\r\n\r\n",
+                      health_tasks[health_previous.failed_task].name,
+                      (unsigned int)health_previous.failed_task_age,
+                      (unsigned int)health_previous.failed_task_deadline);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_health_heartbeat
+ *******************************************************************************
+ * Summary:
+ *   Called by a supervised task once per loop. Records the loop time in the
+ *   histogram and announces when the next heartbeat is due. Loops which
+ *   followed a deadline of 0 are not added to the histogram.
+ *
+ * Parameters:
+ *   task: supervised task
+ *   next_deadline_ms: time until the next heartbeat in ms
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_health_heartbeat(pasco2_health_task_t task, uint32_t next_deadline_ms)
+{
+    health_task_state_t *state = &health_tasks[task];
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    uint32_t loop = (uint32_t)now - state->last_heartbeat;
+    /* A deadline of 0 only asks for an immediate retry, the loop time in
+     * percent of it means nothing */
+    if (state->deadline > 0U)
+    {
+        uint32_t percent = (loop < (UINT32_MAX / 100U)) ? ((loop * 100U) / state->deadline) : UINT32_MAX;
+        uint32_t bucket = 0;
+        while ((bucket < (PASCO2_HEALTH_HISTOGRAM_BUCKETS - 1U)) && (percent > histogram_limits[bucket]))
+        {
+            bucket++;
+        }
+        state->histogram[bucket]++;
+    }
+    if (loop > (state->deadline + PASCO2_HEALTH_DEADLINE_MARGIN))
+    {
+        state->misses++;
+    }
+    state->last_loop = loop;
+    if (loop > state->max_loop)
+    {
+        state->max_loop = loop;
+    }
+    state->last_heartbeat = (uint32_t)now;
+    state->deadline = next_deadline_ms;
+    cyhal_system_critical_section_exit(critical_section);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_health_check
+ *******************************************************************************
+ * Summary:
+ *   Checks that every supervised task sent its heartbeat within its deadline.
+ *   The watchdog is only fed while all tasks are healthy. Otherwise the
+ *   failing task is saved in the retained snapshot and the watchdog resets
+ *   the device after its timeout.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if all tasks are healthy
+ *******************************************************************************/
+bool pasco2_health_check(void)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    uint32_t failed_task = HEALTH_TASK_NONE;
+    uint32_t age = 0;
+    uint32_t deadline = 0;
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    for (uint32_t i = 0; i < PASCO2_HEALTH_TASK_COUNT; i++)
+    {
+        age = (uint32_t)now - health_tasks[i].last_heartbeat;
+        deadline = health_tasks[i].deadline;
+        if (age > (deadline + PASCO2_HEALTH_DEADLINE_MARGIN))
+        {
+            failed_task = i;
+            break;
+        }
+    }
+    cyhal_system_critical_section_exit(critical_section);
+
+    health_snapshot.uptime = (uint32_t)now;
+    if (failed_task == HEALTH_TASK_NONE)
+    {
+        cyhal_wdt_kick(&health_wdt);
+        return true;
+    }
+    if (health_snapshot.failed_task == HEALTH_TASK_NONE)
+    {
+        /* Stop feeding the watchdog, the device resets after the timeout */
+        health_snapshot.failed_task = failed_task;
+        health_snapshot.failed_task_age = age;
+        health_snapshot.failed_task_deadline = deadline;
+        pasco2_printf("%s task missed its deadline, reset by watchdog\r\n", health_tasks[failed_task].name);
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_health_task
+ *******************************************************************************
+ * Summary:
+ *   Starts the hardware watchdog and checks the heartbeats of the supervised
+ *   tasks every PASCO2_HEALTH_CHECK_PERIOD.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_health_task(cy_thread_arg_t arg)
+{
+    cy_rslt_t result = cyhal_wdt_init(&health_wdt, PASCO2_HEALTH_WDT_TIMEOUT);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    for (;;)
+    {
+        (void)pasco2_health_check();
+        vTaskDelay(PASCO2_HEALTH_CHECK_PERIOD);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_health_print_statistics
+ *******************************************************************************
+ * Summary:
+ *   Prints reset information and the loop time statistics of all supervised
+ *   tasks.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_health_print_statistics(void)
+{
+    pasco2_printf("Boot count: %u, watchdog resets: %u, reset reason: 0x%x\r\n",
+                  (unsigned int)health_snapshot.boot_count,
+                  (unsigned int)health_snapshot.watchdog_resets,
+                  (unsigned int)health_snapshot.reset_reason);
+    if (health_previous.boot_count > 0U)
+    {
+        pasco2_printf("Previous run: uptime %u ms, failed task: %s\r\n",
+                      (unsigned int)health_previous.uptime,
+                      (health_previous.failed_task < PASCO2_HEALTH_TASK_COUNT)
+                          ? health_tasks[health_previous.failed_task].name
+                          : "none");
+    }
+
+    pasco2_printf("Loop time histogram in percent of the deadline\r\n");
+    pasco2_printf("%-12s %8s %8s %6s %6s %6s %6s %6s %6s %6s\r\n",
+                  "Task",
+                  "Last ms",
+                  "Max ms",
+                  "Misses",
+                  "<=100",
+                  "<=110",
+                  "<=125",
+                  "<=150",
+                  "<=200",
+                  ">200");
+    for (uint32_t i = 0; i < PASCO2_HEALTH_TASK_COUNT; i++)
+    {
+        const health_task_state_t *state = &health_tasks[i];
+        pasco2_printf("%-12s %8u %8u %6u",
+                      state->name,
+                      (unsigned int)state->last_loop,
+                      (unsigned int)state->max_loop,
+                      (unsigned int)state->misses);
+        for (uint32_t bucket = 0; bucket < PASCO2_HEALTH_HISTOGRAM_BUCKETS; bucket++)
+        {
+            pasco2_printf(" %6u", (unsigned int)state->histogram[bucket]);
+        }
+        pasco2_printf("\r\n");
+    }
+    pasco2_printf("\r\n");
+}
@@ -0,0 +1,67 @@
+/******************************************************************************
+** File name: pasco2_health.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_health.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Name of the health monitor task, its stack and priority are set in
+ * pasco2_board.h */
+#define PASCO2_HEALTH_TASK_NAME "HEALTH MONITOR"
+/* Interval in ms in which the heartbeats are checked */
+#define PASCO2_HEALTH_CHECK_PERIOD (1000U)
+/* Hardware watchdog timeout in ms, has to be longer than the check period */
+#define PASCO2_HEALTH_WDT_TIMEOUT (4000U)
+/* Time in ms a task or job may exceed its announced deadline (I2C transfers,
+ * UART output) */
+#define PASCO2_HEALTH_DEADLINE_MARGIN (5000U)
+/* Number of buckets of the loop time histogram */
+#define PASCO2_HEALTH_HISTOGRAM_BUCKETS (6U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Supervised tasks and jobs */
+typedef enum
+{
+    PASCO2_HEALTH_SENSOR_JOB,
+    PASCO2_HEALTH_EXECUTOR,
+    PASCO2_HEALTH_TASK_COUNT
+} pasco2_health_task_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_health_init(void);
+void pasco2_health_task(cy_thread_arg_t arg);
+bool pasco2_health_check(void);
+void pasco2_health_heartbeat(pasco2_health_task_t task, uint32_t next_deadline_ms);
+void pasco2_health_print_statistics(void);
@@ -0,0 +1,216 @@
+/*****************************************************************************
+** File name: pasco2_i2c_record.c
+**
+** Description: This file implements a binary recorder of all I2C transfers
+** of the application. The recording can be replayed with
+** pasco2_i2c_replay.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#if defined(PASCO2_I2C_RECORD_ENABLED)
+
+/* Header file from system */
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "pasco2_i2c_record.h"
+#include "pasco2_print.h"
+
+/* Number of bytes printed per line by pasco2_i2c_record_dump */
+#define I2C_RECORD_DUMP_LINE_LENGTH (32U)
+/* Number of records in the ring after the prologue */
+#define I2C_RECORD_RING (PASCO2_I2C_RECORD_TRANSFERS - PASCO2_I2C_RECORD_PROLOGUE)
+
+static_assert(PASCO2_I2C_RECORD_PROLOGUE < PASCO2_I2C_RECORD_TRANSFERS, "the recording needs a ring");
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+/* Recording, can also be saved with the debugger by its symbol name */
+pasco2_i2c_recording_t pasco2_i2c_recording = {
+    .magic = PASCO2_I2C_RECORD_MAGIC,
+    .version = PASCO2_I2C_RECORD_VERSION,
+    .record_size = sizeof(pasco2_i2c_record_t),
+    .capacity = PASCO2_I2C_RECORD_TRANSFERS,
+    .prologue = PASCO2_I2C_RECORD_PROLOGUE,
+};
+
+/* Transfers were dropped during a manual dump, the next record is flagged */
+static bool record_gap = false;
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_record_add
+ *******************************************************************************
+ * Summary:
+ *   Appends a transfer to the recording. The first transfers after boot fill
+ *   the prologue, later ones overwrite the oldest record of the ring.
+ *   Transfers after the recording was frozen are only counted. The first
+ *   transfer after the transfers dropped during a manual dump is flagged
+ *   with PASCO2_I2C_OP_RESYNC, so that the replay continues there.
+ *
+ * Parameters:
+ *   op: PASCO2_I2C_OP_* transfer type
+ *   address: device address
+ *   mem_addr: register address of memory transfers
+ *   data: bytes written or read
+ *   size: number of bytes
+ *   result: result of the transfer
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_i2c_record_add(uint8_t op,
+                           uint16_t address,
+                           uint16_t mem_addr,
+                           const uint8_t *data,
+                           uint16_t size,
+                           cy_rslt_t result)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    /* Reserve the record, it is filled outside of the critical section */
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    bool frozen = (pasco2_i2c_recording.frozen != 0U);
+    uint32_t index = pasco2_i2c_recording.count;
+    if (frozen)
+    {
+        pasco2_i2c_recording.dropped++;
+    }
+    else
+    {
+        pasco2_i2c_recording.count++;
+        if (record_gap)
+        {
+            op |= PASCO2_I2C_OP_RESYNC;
+            record_gap = false;
+        }
+    }
+    cyhal_system_critical_section_exit(critical_section);
+
+    if (frozen)
+    {
+        return;
+    }
+    if (index >= PASCO2_I2C_RECORD_PROLOGUE)
+    {
+        index = PASCO2_I2C_RECORD_PROLOGUE + ((index - PASCO2_I2C_RECORD_PROLOGUE) % I2C_RECORD_RING);
+    }
+    pasco2_i2c_record_t *record = &pasco2_i2c_recording.records[index];
+    record->timestamp = (uint32_t)now;
+    record->result = result;
+    record->op = op;
+    record->address = (uint8_t)address;
+    record->mem_addr = (uint8_t)mem_addr;
+    record->size = (size > UINT8_MAX) ? UINT8_MAX : (uint8_t)size;
+    memcpy(record->data, data, (size < PASCO2_I2C_RECORD_DATA_SIZE) ? size : PASCO2_I2C_RECORD_DATA_SIZE);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_record_freeze
+ *******************************************************************************
+ * Summary:
+ *   Stops the recording, so that the ring keeps the transfers which led to an
+ *   error. Only the first call has an effect, except that an error replaces
+ *   the CY_RSLT_SUCCESS trigger of a manual dump in progress, which then
+ *   leaves the recording frozen.
+ *
+ * Parameters:
+ *   trigger: result which caused the freeze
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_i2c_record_freeze(cy_rslt_t trigger)
+{
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    if ((pasco2_i2c_recording.frozen == 0U) ||
+        ((pasco2_i2c_recording.trigger == CY_RSLT_SUCCESS) && (trigger != CY_RSLT_SUCCESS)))
+    {
+        pasco2_i2c_recording.frozen = 1U;
+        pasco2_i2c_recording.trigger = trigger;
+    }
+    cyhal_system_critical_section_exit(critical_section);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_record_dump
+ *******************************************************************************
+ * Summary:
+ *   Freezes the recording, if no error has frozen it before, and prints it
+ *   as hex lines framed by begin and end markers. The records are printed in
+ *   memory order, scripts/pasco2_i2c_session.py restores the order of the
+ *   ring. A recording frozen for the dump only, with trigger
+ *   CY_RSLT_SUCCESS, is resumed afterwards; a recording frozen by an error
+ *   stays frozen.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_i2c_record_dump(void)
+{
+    uint32_t critical_section = cyhal_system_critical_section_enter();
+    bool manual = (pasco2_i2c_recording.frozen == 0U);
+    cyhal_system_critical_section_exit(critical_section);
+    pasco2_i2c_record_freeze(CY_RSLT_SUCCESS);
+    uint32_t count = pasco2_i2c_recording.count;
+    uint32_t stored = (count < PASCO2_I2C_RECORD_TRANSFERS) ? count : PASCO2_I2C_RECORD_TRANSFERS;
+    const uint8_t *data = (const uint8_t *)&pasco2_i2c_recording;
+    uint32_t length = (uint32_t)offsetof(pasco2_i2c_recording_t, records) + (stored * sizeof(pasco2_i2c_record_t));
+
+    pasco2_printf("PASCO2-I2C-BEGIN\r\n");
+    for (uint32_t i = 0; i < length; i++)
+    {
+        pasco2_printf("%02x", data[i]);
+        if (((i + 1U) % I2C_RECORD_DUMP_LINE_LENGTH) == 0U)
+        {
+            pasco2_printf("\r\n");
+        }
+    }
+    pasco2_printf("\r\nPASCO2-I2C-END\r\n");
+    pasco2_printf("%u transfers recorded, %u stored, %u after the freeze by result 0x%08x\r\n\r\n",
+                  (unsigned int)count,
+                  (unsigned int)stored,
+                  (unsigned int)pasco2_i2c_recording.dropped,
+                  (unsigned int)pasco2_i2c_recording.trigger);
+
+    /* Resume unless an error has frozen the recording during the dump */
+    critical_section = cyhal_system_critical_section_enter();
+    if (manual && (pasco2_i2c_recording.trigger == CY_RSLT_SUCCESS))
+    {
+        pasco2_i2c_recording.frozen = 0U;
+        record_gap = record_gap || (pasco2_i2c_recording.dropped != 0U);
+        pasco2_i2c_recording.dropped = 0U;
+    }
+    cyhal_system_critical_section_exit(critical_section);
+}
+
+#endif /* defined(PASCO2_I2C_RECORD_ENABLED) */
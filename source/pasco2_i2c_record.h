@@ -0,0 +1,130 @@
+/******************************************************************************
+** File name: pasco2_i2c_record.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_i2c_record.c and pasco2_i2c_replay.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of transfers in the recording */
+#define PASCO2_I2C_RECORD_TRANSFERS (512U)
+/* Number of transfers kept from boot, so that a session can be replayed from
+ * the sensor initialization. The remaining records are a ring of the latest
+ * transfers. */
+#define PASCO2_I2C_RECORD_PROLOGUE (64U)
+/* Number of data bytes stored per transfer, longer transfers are truncated */
+#define PASCO2_I2C_RECORD_DATA_SIZE (12U)
+/* Magic value at the start of the recording ("PI2C") */
+#define PASCO2_I2C_RECORD_MAGIC (0x43324950UL)
+/* Version of the binary recording layout */
+#define PASCO2_I2C_RECORD_VERSION (2U)
+
+/* Transfer types, the values are part of the binary recording layout */
+#define PASCO2_I2C_OP_WRITE     (1U) /* cyhal_i2c_master_write */
+#define PASCO2_I2C_OP_READ      (2U) /* cyhal_i2c_master_read */
+#define PASCO2_I2C_OP_MEM_WRITE (3U) /* cyhal_i2c_master_mem_write */
+#define PASCO2_I2C_OP_MEM_READ  (4U) /* cyhal_i2c_master_mem_read */
+/* Flag for transfers which end without a stop condition */
+#define PASCO2_I2C_OP_NO_STOP (0x80U)
+/* Flag on the first transfer after missing transfers: set by
+ * pasco2_i2c_record_add after the transfers dropped during a manual dump, and
+ * by scripts/pasco2_i2c_session.py after the transfers lost between the
+ * prologue and the ring */
+#define PASCO2_I2C_OP_RESYNC (0x40U)
+
+/* Time in ms a replayed transfer may be later than recorded before it is
+ * reported as late */
+#define PASCO2_I2C_REPLAY_TOLERANCE (2U)
+/* The transfer does not match the recording or the recording has ended */
+#define PASCO2_I2C_REPLAY_RSLT_ERR_DIVERGED (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 1))
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t timestamp; /* ms since start of the scheduler */
+    uint32_t result;    /* cy_rslt_t of the transfer */
+    uint8_t op;         /* PASCO2_I2C_OP_* */
+    uint8_t address;    /* 7 bit device address */
+    uint8_t mem_addr;   /* register address of memory transfers */
+    uint8_t size;       /* number of bytes transferred */
+    uint8_t data[PASCO2_I2C_RECORD_DATA_SIZE];
+} pasco2_i2c_record_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t prologue; /* records kept from boot, followed by the ring */
+    uint32_t count;    /* number of recorded transfers, including overwritten ones */
+    uint32_t dropped;  /* transfers after the recording was frozen */
+    uint32_t frozen;   /* 1 when the recording is frozen */
+    uint32_t trigger;  /* cy_rslt_t which froze the recording */
+    pasco2_i2c_record_t records[PASCO2_I2C_RECORD_TRANSFERS];
+} pasco2_i2c_recording_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_i2c_record_add(uint8_t op,
+                           uint16_t address,
+                           uint16_t mem_addr,
+                           const uint8_t *data,
+                           uint16_t size,
+                           cy_rslt_t result);
+void pasco2_i2c_record_freeze(cy_rslt_t trigger);
+void pasco2_i2c_record_dump(void);
+
+cy_rslt_t pasco2_i2c_replay_transfer(uint8_t op,
+                                     uint16_t address,
+                                     uint16_t mem_addr,
+                                     const uint8_t *write_data,
+                                     uint8_t *read_data,
+                                     uint16_t size);
+
+/* Recorded session replayed by pasco2_i2c_replay_transfer, generated by
+ * scripts/pasco2_i2c_session.py */
+extern const pasco2_i2c_record_t pasco2_i2c_session[];
+extern const uint32_t pasco2_i2c_session_length;
+
+/*******************************************************************************
+ * Instrumentation macros
+ *******************************************************************************/
+#if defined(PASCO2_I2C_RECORD_ENABLED)
+#define PASCO2_I2C_RECORD(op, address, mem_addr, data, size, result)                                                  \
+    pasco2_i2c_record_add((op), (address), (mem_addr), (data), (size), (result))
+#define PASCO2_I2C_RECORD_FREEZE(trigger) pasco2_i2c_record_freeze(trigger)
+#else
+#define PASCO2_I2C_RECORD(op, address, mem_addr, data, size, result)
+#define PASCO2_I2C_RECORD_FREEZE(trigger)
+#endif /* defined(PASCO2_I2C_RECORD_ENABLED) */
@@ -0,0 +1,239 @@
+/*****************************************************************************
+** File name: pasco2_i2c_replay.c
+**
+** Description: This file implements an I2C backend which replays a session
+** recorded by pasco2_i2c_record.c instead of accessing the bus. Each transfer
+** is checked against the recording, delayed to its recorded time and
+** completed with the recorded data and result.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#if defined(PASCO2_I2C_REPLAY_ENABLED)
+
+/* Header file from system */
+#include <stdbool.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "pasco2_i2c_record.h"
+#include "pasco2_print.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+static uint32_t replay_index = 0;
+static bool replay_diverged = false;
+static cy_time_t replay_start;
+static uint32_t replay_late = 0;
+static uint32_t replay_max_late = 0;
+static uint32_t replay_skipped = 0;
+
+/*******************************************************************************
+ * Function Name: replay_matches
+ *******************************************************************************
+ * Summary:
+ *   Checks a transfer against a recorded transfer.
+ *
+ * Parameters:
+ *   record: recorded transfer
+ *   op: PASCO2_I2C_OP_* transfer type
+ *   address: device address
+ *   mem_addr: register address of memory transfers
+ *   write_data: bytes to be written, NULL for reads
+ *   size: number of bytes
+ *
+ * Return:
+ *   true if the transfer matches the recording
+ *******************************************************************************/
+static bool replay_matches(const pasco2_i2c_record_t *record,
+                           uint8_t op,
+                           uint16_t address,
+                           uint16_t mem_addr,
+                           const uint8_t *write_data,
+                           uint16_t size)
+{
+    if (((record->op & (uint8_t)~PASCO2_I2C_OP_RESYNC) != op) || (record->address != address) ||
+        (record->mem_addr != (uint8_t)mem_addr) || (record->size != size))
+    {
+        return false;
+    }
+    return (write_data == NULL) ||
+           (memcmp(record->data,
+                   write_data,
+                   (size < PASCO2_I2C_RECORD_DATA_SIZE) ? size : PASCO2_I2C_RECORD_DATA_SIZE) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: replay_resync
+ *******************************************************************************
+ * Summary:
+ *   Continues the replay after transfers missing from the recording at the
+ *   first recorded write which matches the transfer. Reads carry no register address and are not used to resync.
+ *   The time base is moved so that the matching record is due now.
+ *
+ * Parameters:
+ *   op: PASCO2_I2C_OP_* transfer type
+ *   address: device address
+ *   mem_addr: register address of memory transfers
+ *   write_data: bytes to be written, NULL for reads
+ *   size: number of bytes
+ *   now: current time
+ *
+ * Return:
+ *   true if a matching record was found
+ *******************************************************************************/
+static bool replay_resync(
+    uint8_t op, uint16_t address, uint16_t mem_addr, const uint8_t *write_data, uint16_t size, cy_time_t now)
+{
+    if (write_data == NULL)
+    {
+        return false;
+    }
+    for (uint32_t i = replay_index; i < pasco2_i2c_session_length; i++)
+    {
+        if (replay_matches(&pasco2_i2c_session[i], op, address, mem_addr, write_data, size))
+        {
+            replay_skipped += i - replay_index;
+            replay_index = i;
+            replay_start = now - (cy_time_t)(pasco2_i2c_session[i].timestamp - pasco2_i2c_session[0].timestamp);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: replay_report
+ *******************************************************************************
+ * Summary:
+ *   Prints the outcome of the replay.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void replay_report(void)
+{
+    pasco2_printf("I2C replay %s after %u of %u transfers, %u skipped to resync, %u late (max %u ms)\r\n",
+                  replay_diverged ? "diverged" : "completed",
+                  (unsigned int)replay_index,
+                  (unsigned int)pasco2_i2c_session_length,
+                  (unsigned int)replay_skipped,
+                  (unsigned int)replay_late,
+                  (unsigned int)replay_max_late);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_replay_transfer
+ *******************************************************************************
+ * Summary:
+ *   Replaces an I2C transfer by the next transfer of the recorded session.
+ *   The transfer is delayed until its recorded time relative to the first
+ *   transfer, so the application sees the recorded timing. Transfers which
+ *   start later than recorded are counted as late. At a gap in a ring
+ *   recording the replay resynchronizes on the next matching write. A
+ *   transfer which does not match the recording stops the replay.
+ *
+ * Parameters:
+ *   op: PASCO2_I2C_OP_* transfer type
+ *   address: device address
+ *   mem_addr: register address of memory transfers
+ *   write_data: bytes to be written, NULL for reads
+ *   read_data: buffer for the bytes read, NULL for writes
+ *   size: number of bytes
+ *
+ * Return:
+ *   Recorded result of the transfer
+ *******************************************************************************/
+cy_rslt_t pasco2_i2c_replay_transfer(uint8_t op,
+                                     uint16_t address,
+                                     uint16_t mem_addr,
+                                     const uint8_t *write_data,
+                                     uint8_t *read_data,
+                                     uint16_t size)
+{
+    if (replay_diverged || (replay_index >= pasco2_i2c_session_length))
+    {
+        return PASCO2_I2C_REPLAY_RSLT_ERR_DIVERGED;
+    }
+
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+    if (replay_index == 0U)
+    {
+        replay_start = now;
+    }
+    if (((pasco2_i2c_session[replay_index].op & PASCO2_I2C_OP_RESYNC) != 0U) &&
+        !replay_resync(op, address, mem_addr, write_data, size, now))
+    {
+        /* The transfers of the application before the gap are completed
+         * without a record until a write matches */
+        if (read_data != NULL)
+        {
+            memset(read_data, 0, size);
+        }
+        replay_skipped++;
+        return CY_RSLT_SUCCESS;
+    }
+
+    const pasco2_i2c_record_t *record = &pasco2_i2c_session[replay_index];
+    if (!replay_matches(record, op, address, mem_addr, write_data, size))
+    {
+        replay_diverged = true;
+        pasco2_printf("I2C replay: transfer %u does not match the recording\r\n", (unsigned int)replay_index);
+        replay_report();
+        return PASCO2_I2C_REPLAY_RSLT_ERR_DIVERGED;
+    }
+
+    uint32_t due = record->timestamp - pasco2_i2c_session[0].timestamp;
+    uint32_t elapsed = (uint32_t)(now - replay_start);
+    if (elapsed < due)
+    {
+        cy_rtos_delay_milliseconds(due - elapsed);
+    }
+    else if ((elapsed - due) > PASCO2_I2C_REPLAY_TOLERANCE)
+    {
+        replay_late++;
+        if ((elapsed - due) > replay_max_late)
+        {
+            replay_max_late = elapsed - due;
+        }
+    }
+
+    if (read_data != NULL)
+    {
+        memset(read_data, 0, size);
+        memcpy(read_data, record->data, (size < PASCO2_I2C_RECORD_DATA_SIZE) ? size : PASCO2_I2C_RECORD_DATA_SIZE);
+    }
+    replay_index++;
+    if (replay_index == pasco2_i2c_session_length)
+    {
+        replay_report();
+    }
+    return record->result;
+}
+
+#endif /* defined(PASCO2_I2C_REPLAY_ENABLED) */
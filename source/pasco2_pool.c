@@ -0,0 +1,217 @@
+/*****************************************************************************
+** File name: pasco2_pool.c
+**
+** Description: This file implements fixed-size block pools with O(1),
+** lock-free and ISR-safe allocation and usage statistics.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_pool.h"
+#include "pasco2_print.h"
+
+#define POOL_HEAD(tag, index) ((((uint32_t)(tag)) << 16) | ((uint32_t)(index)))
+#define POOL_HEAD_TAG(head)   ((uint16_t)((head) >> 16))
+#define POOL_HEAD_INDEX(head) ((uint16_t)((head)&0xFFFFU))
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+/* List of all initialized pools */
+static pasco2_pool_t *pool_list = NULL;
+
+/*******************************************************************************
+ * Function Name: pool_next_index
+ *******************************************************************************
+ * Summary:
+ *   Returns the free-list link which is stored in the first bytes of a free
+ *   block.
+ *
+ * Parameters:
+ *   pool: pool object
+ *   index: block index
+ *
+ * Return:
+ *   pointer to the free-list link
+ *******************************************************************************/
+static inline volatile uint16_t *pool_next_index(pasco2_pool_t *pool, uint16_t index)
+{
+    return (volatile uint16_t *)&pool->storage[(uint32_t)index * pool->block_size];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pool_init
+ *******************************************************************************
+ * Summary:
+ *   Links all blocks of a pool into its free-list, resets the statistics and
+ *   registers the pool for pasco2_pool_print_statistics. Has to be called
+ *   once per pool before the scheduler is started.
+ *
+ * Parameters:
+ *   pool: pool object defined with PASCO2_POOL_DEFINE
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_pool_init(pasco2_pool_t *pool)
+{
+    CY_ASSERT(pool->block_count < PASCO2_POOL_INDEX_NONE);
+
+    for (uint16_t i = 0; i < pool->block_count; i++)
+    {
+        *pool_next_index(pool, i) = ((i + 1U) < pool->block_count) ? (uint16_t)(i + 1U) : PASCO2_POOL_INDEX_NONE;
+    }
+    pool->free_head = POOL_HEAD(0U, (pool->block_count > 0U) ? 0U : PASCO2_POOL_INDEX_NONE);
+    pool->used = 0;
+    pool->high_water = 0;
+    pool->allocations = 0;
+    pool->failures = 0;
+
+    pool->next_pool = pool_list;
+    pool_list = pool;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pool_alloc
+ *******************************************************************************
+ * Summary:
+ *   Takes a block from the pool in constant time. Safe to be called from
+ *   tasks and ISRs.
+ *
+ * Parameters:
+ *   pool: pool object
+ *
+ * Return:
+ *   pointer to the block, NULL if the pool is exhausted
+ *******************************************************************************/
+void *pasco2_pool_alloc(pasco2_pool_t *pool)
+{
+    uint32_t head = __atomic_load_n(&pool->free_head, __ATOMIC_ACQUIRE);
+    uint32_t new_head;
+    uint16_t index;
+
+    do
+    {
+        index = POOL_HEAD_INDEX(head);
+        if (index == PASCO2_POOL_INDEX_NONE)
+        {
+            __atomic_fetch_add(&pool->failures, 1U, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        /* The link may be stale if another context took the block meanwhile,
+         * the tag makes the exchange fail in that case. */
+        new_head = POOL_HEAD(POOL_HEAD_TAG(head) + 1U, *pool_next_index(pool, index));
+    } while (!__atomic_compare_exchange_n(
+        &pool->free_head, &head, new_head, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    __atomic_fetch_add(&pool->allocations, 1U, __ATOMIC_RELAXED);
+    uint32_t used = __atomic_add_fetch(&pool->used, 1U, __ATOMIC_RELAXED);
+    uint32_t high_water = __atomic_load_n(&pool->high_water, __ATOMIC_RELAXED);
+    while ((used > high_water) &&
+           !__atomic_compare_exchange_n(
+               &pool->high_water, &high_water, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+
+    return &pool->storage[(uint32_t)index * pool->block_size];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pool_free
+ *******************************************************************************
+ * Summary:
+ *   Returns a block to the pool in constant time. Safe to be called from
+ *   tasks and ISRs.
+ *
+ * Parameters:
+ *   pool: pool object the block was taken from
+ *   block: block to be returned, NULL is ignored
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_pool_free(pasco2_pool_t *pool, void *block)
+{
+    if (block == NULL)
+    {
+        return;
+    }
+
+    uint32_t offset = (uint32_t)((uint8_t *)block - pool->storage);
+    CY_ASSERT((offset % pool->block_size) == 0U);
+    uint16_t index = (uint16_t)(offset / pool->block_size);
+    CY_ASSERT(index < pool->block_count);
+
+    uint32_t head = __atomic_load_n(&pool->free_head, __ATOMIC_ACQUIRE);
+    do
+    {
+        *pool_next_index(pool, index) = POOL_HEAD_INDEX(head);
+    } while (!__atomic_compare_exchange_n(&pool->free_head,
+                                          &head,
+                                          POOL_HEAD(POOL_HEAD_TAG(head) + 1U, index),
+                                          true,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE));
+
+    __atomic_fetch_sub(&pool->used, 1U, __ATOMIC_RELAXED);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pool_print_statistics
+ *******************************************************************************
+ * Summary:
+ *   Prints usage, high-water mark and allocation failures of all pools.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_pool_print_statistics(void)
+{
+    if (pool_list == NULL)
+    {
+        pasco2_printf("No memory pools in use\r\n\r\n");
+        return;
+    }
+
+    pasco2_printf("%-24s %6s %6s %6s %6s %10s %8s\r\n", "Pool", "Size", "Blocks", "Used", "Peak", "Allocs", "Failures");
+    for (pasco2_pool_t *pool = pool_list; pool != NULL; pool = pool->next_pool)
+    {
+        pasco2_printf("%-24s %6u %6u %6u %6u %10u %8u\r\n",
+                      pool->name,
+                      pool->block_size,
+                      pool->block_count,
+                      (unsigned int)pool->used,
+                      (unsigned int)pool->high_water,
+                      (unsigned int)pool->allocations,
+                      (unsigned int)pool->failures);
+    }
+    pasco2_printf("\r\n");
+}
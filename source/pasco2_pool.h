@@ -0,0 +1,78 @@
+/******************************************************************************
+** File name: pasco2_pool.h
+**
+** Description: This file contains the function prototypes, types and macros
+**   used in pasco2_pool.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Index marking the end of a free-list */
+#define PASCO2_POOL_INDEX_NONE (0xFFFFU)
+
+/* Rounds a block size up to the 4 byte alignment of the pool storage */
+#define PASCO2_POOL_BLOCK_SIZE(size) ((((size) < 4U ? 4U : (size)) + 3U) & ~3U)
+
+/* Defines a pool with statically allocated storage. The pool has to be
+ * registered with pasco2_pool_init before use. */
+#define PASCO2_POOL_DEFINE(pool_name, size, count)                                                                     \
+    static uint32_t pool_name##_storage[(PASCO2_POOL_BLOCK_SIZE(size) / 4U) * (count)];                                \
+    pasco2_pool_t pool_name = {                                                                                        \
+        .name = #pool_name,                                                                                            \
+        .storage = (uint8_t *)pool_name##_storage,                                                                     \
+        .block_size = PASCO2_POOL_BLOCK_SIZE(size),                                                                    \
+        .block_count = (count),                                                                                        \
+    }
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct pasco2_pool
+{
+    const char *name;
+    uint8_t *storage;
+    uint16_t block_size;
+    uint16_t block_count;
+    struct pasco2_pool *next_pool;
+
+    /* Free-list head: modification tag in the upper, block index in the lower
+     * half word. The tag prevents the ABA problem of the lock-free list. */
+    volatile uint32_t free_head;
+
+    /* Statistics */
+    volatile uint32_t used;
+    volatile uint32_t high_water;
+    volatile uint32_t allocations;
+    volatile uint32_t failures;
+} pasco2_pool_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_pool_init(pasco2_pool_t *pool);
+void *pasco2_pool_alloc(pasco2_pool_t *pool);
+void pasco2_pool_free(pasco2_pool_t *pool, void *block);
+void pasco2_pool_print_statistics(void);
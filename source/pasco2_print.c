@@ -0,0 +1,332 @@
+/*****************************************************************************
+** File name: pasco2_print.c
+**
+** Description: This file implements a small, reentrant and allocation-free
+** formatter which writes directly to the debug UART. A mutex keeps the lines
+** of different tasks from interleaving.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "FreeRTOS.h"
+#include "cy_retarget_io.h"
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "pasco2_print.h"
+
+/* Sign and digits of a 32 bit decimal value */
+#define PRINT_DIGITS_MAXLENGTH (11U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Held by the task which writes to the debug UART */
+static cy_mutex_t print_mutex;
+
+/*******************************************************************************
+ * Function Name: print_putc
+ *******************************************************************************
+ * Summary:
+ *   Writes a character to the debug UART. Blocks while the TX FIFO is full.
+ *   Line feeds are converted like in the retarget-io printf when
+ *   CY_RETARGET_IO_CONVERT_LF_TO_CRLF is defined.
+ *
+ * Parameters:
+ *   c: character to be written
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static inline void print_putc(char c)
+{
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+    if (c == '\n')
+    {
+        (void)cyhal_uart_putc(&cy_retarget_io_uart_obj, (uint32_t)'\r');
+    }
+#endif
+    (void)cyhal_uart_putc(&cy_retarget_io_uart_obj, (uint32_t)(uint8_t)c);
+}
+
+/*******************************************************************************
+ * Function Name: print_padded
+ *******************************************************************************
+ * Summary:
+ *   Writes a string padded to the given width.
+ *
+ * Parameters:
+ *   str: string to be written
+ *   length: number of characters of str
+ *   width: minimum field width
+ *   pad: padding character
+ *   left_align: pad on the right instead of the left
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+static int print_padded(const char *str, unsigned int length, unsigned int width, char pad, bool left_align)
+{
+    unsigned int count = 0;
+    unsigned int padding = (width > length) ? (width - length) : 0U;
+
+    /* A sign stays in front of zero padding */
+    if ((pad == '0') && !left_align && (length > 0U) && (*str == '-'))
+    {
+        print_putc(*str++);
+        length--;
+        count++;
+    }
+    while (!left_align && (padding > 0U))
+    {
+        print_putc(pad);
+        padding--;
+        count++;
+    }
+    while (length > 0U)
+    {
+        print_putc(*str++);
+        length--;
+        count++;
+    }
+    while (padding > 0U)
+    {
+        print_putc(' ');
+        padding--;
+        count++;
+    }
+    return (int)count;
+}
+
+/*******************************************************************************
+ * Function Name: print_format
+ *******************************************************************************
+ * Summary:
+ *   Formats and writes a string to the debug UART. Supports the conversions
+ *   %d, %i, %u, %x, %X, %c, %s and %% with the flags '-' and '0', a decimal
+ *   field width and the length modifiers 'h', 'hh' and 'l'. Floating point
+ *   conversions are not supported. The function uses a few bytes of stack
+ *   only, never allocates memory and keeps no state, so it can be called from
+ *   any task without newlib reentrancy support.
+ *
+ * Parameters:
+ *   format: format string
+ *   args: arguments of the format string
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+static int print_format(const char *format, va_list args)
+{
+    int count = 0;
+
+    while (*format != '\0')
+    {
+        if (*format != '%')
+        {
+            print_putc(*format++);
+            count++;
+            continue;
+        }
+        format++;
+
+        /* Flags */
+        bool left_align = false;
+        char pad = ' ';
+        for (;; format++)
+        {
+            if (*format == '-')
+            {
+                left_align = true;
+            }
+            else if (*format == '0')
+            {
+                pad = '0';
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (left_align)
+        {
+            pad = ' ';
+        }
+
+        /* Field width */
+        unsigned int width = 0;
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = (width * 10U) + (unsigned int)(*format++ - '0');
+        }
+
+        /* Length modifiers, all integers are 32 bit on this target */
+        while ((*format == 'h') || (*format == 'l'))
+        {
+            format++;
+        }
+
+        char digits[PRINT_DIGITS_MAXLENGTH + 1U];
+        char *end = &digits[sizeof(digits)];
+        char *str = end;
+        uint32_t value;
+        uint32_t base = 10U;
+        const char *hex = "0123456789abcdef";
+        bool negative = false;
+
+        switch (*format)
+        {
+            case 'd':
+            case 'i':
+            {
+                int32_t signed_value = va_arg(args, int);
+                negative = (signed_value < 0);
+                value = negative ? (0U - (uint32_t)signed_value) : (uint32_t)signed_value;
+                break;
+            }
+            case 'u':
+                value = va_arg(args, unsigned int);
+                break;
+            case 'X':
+                hex = "0123456789ABCDEF";
+                /* fall through */
+            case 'x':
+                value = va_arg(args, unsigned int);
+                base = 16U;
+                break;
+            case 'c':
+                digits[0] = (char)va_arg(args, int);
+                count += print_padded(digits, 1U, width, ' ', left_align);
+                format++;
+                continue;
+            case 's':
+            {
+                const char *s = va_arg(args, const char *);
+                unsigned int length = 0;
+                while (s[length] != '\0')
+                {
+                    length++;
+                }
+                count += print_padded(s, length, width, ' ', left_align);
+                format++;
+                continue;
+            }
+            case '%':
+                print_putc('%');
+                count++;
+                format++;
+                continue;
+            default:
+                /* Unsupported conversion or end of string, stop formatting */
+                return count;
+        }
+        format++;
+
+        do
+        {
+            *--str = hex[value % base];
+            value /= base;
+        } while (value != 0U);
+        if (negative)
+        {
+            *--str = '-';
+        }
+        count += print_padded(str, (unsigned int)(end - str), width, pad, left_align);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_print_init
+ *******************************************************************************
+ * Summary:
+ *   Creates the mutex which serializes the output of the tasks. Has to be
+ *   called before the scheduler is started.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   Status of the mutex creation
+ *******************************************************************************/
+cy_rslt_t pasco2_print_init(void)
+{
+    return cy_rtos_init_mutex(&print_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_vprintf
+ *******************************************************************************
+ * Summary:
+ *   Formats and writes a string to the debug UART, see print_format. Once
+ *   the scheduler runs, the string is written while holding the print mutex,
+ *   so that the output of the executor and of the health monitor does not
+ *   interleave. Must not be called from an interrupt.
+ *
+ * Parameters:
+ *   format: format string
+ *   args: arguments of the format string
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+int pasco2_vprintf(const char *format, va_list args)
+{
+    bool locked = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+    if (locked)
+    {
+        (void)cy_rtos_get_mutex(&print_mutex, CY_RTOS_NEVER_TIMEOUT);
+    }
+    int count = print_format(format, args);
+    if (locked)
+    {
+        (void)cy_rtos_set_mutex(&print_mutex);
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_printf
+ *******************************************************************************
+ * Summary:
+ *   printf replacement for the application output, see pasco2_vprintf.
+ *
+ * Parameters:
+ *   format: format string
+ *   ...: arguments of the format string
+ *
+ * Return:
+ *   number of characters written
+ *******************************************************************************/
+int pasco2_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = pasco2_vprintf(format, args);
+    va_end(args);
+    return count;
+}
@@ -0,0 +1,49 @@
+/******************************************************************************
+** File name: pasco2_print.h
+**
+** Description: This file contains the function prototypes used in
+**   pasco2_print.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdarg.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Lets the compiler check the arguments against the format string. Only the
+ * subset documented in pasco2_print.c is supported by the formatter. */
+#if defined(__GNUC__)
+#define PASCO2_PRINT_FORMAT_CHECK(format_index, args_index) __attribute__((format(printf, format_index, args_index)))
+#else
+#define PASCO2_PRINT_FORMAT_CHECK(format_index, args_index)
+#endif
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+cy_rslt_t pasco2_print_init(void);
+int pasco2_printf(const char *format, ...) PASCO2_PRINT_FORMAT_CHECK(1, 2);
+int pasco2_vprintf(const char *format, va_list args);
@@ -0,0 +1,573 @@
+/*****************************************************************************
+** File name: pasco2_regcache.c
+**
+** Description: This file implements a write-through shadow cache of the PAS
+** CO2 configuration registers. It is placed between the pasco2 library and
+** the HAL I2C driver with the linker option --wrap, see LDFLAGS in Makefile.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "pasco2_i2c_record.h"
+#include "pasco2_print.h"
+#include "pasco2_regcache.h"
+
+/* Registers which only change when written by the host. Status, measurement
+ * result and MEAS_CFG (the sensor clears the operating mode after a single
+ * shot) are always read from the sensor. PROD_ID and SCRATCH_PAD are read by
+ * the driver to check that the sensor is present and responding, serving them
+ * from the cache would hide a lost sensor. */
+#define REGCACHE_CACHEABLE                                                                                             \
+    ((1UL << PASCO2_REG_MEAS_RATE_H) | (1UL << PASCO2_REG_MEAS_RATE_L) | (1UL << PASCO2_REG_INT_CFG) |                 \
+     (1UL << PASCO2_REG_ALARM_TH_H) | (1UL << PASCO2_REG_ALARM_TH_L) | (1UL << PASCO2_REG_PRESS_REF_H) |               \
+     (1UL << PASCO2_REG_PRESS_REF_L) | (1UL << PASCO2_REG_CALIB_REF_H) | (1UL << PASCO2_REG_CALIB_REF_L))
+
+/*******************************************************************************
+ * Functions provided by the linker for the wrapped HAL functions
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_write(cyhal_i2c_t *obj,
+                                        uint16_t dev_addr,
+                                        const uint8_t *data,
+                                        uint16_t size,
+                                        uint32_t timeout,
+                                        bool send_stop);
+cy_rslt_t __real_cyhal_i2c_master_read(cyhal_i2c_t *obj,
+                                       uint16_t dev_addr,
+                                       uint8_t *data,
+                                       uint16_t size,
+                                       uint32_t timeout,
+                                       bool send_stop);
+cy_rslt_t __real_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout);
+cy_rslt_t __real_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+static uint8_t regcache_values[PASCO2_REG_COUNT];
+static uint32_t regcache_valid = 0;
+static pasco2_regcache_statistics_t regcache_statistics;
+
+/* Register address set by the last write without data, the next read starts
+ * there */
+static struct
+{
+    bool valid;
+    uint8_t reg;
+} regcache_pointer;
+
+/*******************************************************************************
+ * Function Name: regcache_bus_write
+ *******************************************************************************
+ * Summary:
+ *   Performs a write on the bus, or on the replay backend, and records it.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_write
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+static cy_rslt_t regcache_bus_write(cyhal_i2c_t *obj,
+                                    uint16_t dev_addr,
+                                    const uint8_t *data,
+                                    uint16_t size,
+                                    uint32_t timeout,
+                                    bool send_stop)
+{
+#if defined(PASCO2_I2C_REPLAY_ENABLED)
+    cy_rslt_t result = pasco2_i2c_replay_transfer(
+        PASCO2_I2C_OP_WRITE | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), dev_addr, 0U, data, NULL, size);
+#else
+    cy_rslt_t result = __real_cyhal_i2c_master_write(obj, dev_addr, data, size, timeout, send_stop);
+#endif
+    PASCO2_I2C_RECORD(PASCO2_I2C_OP_WRITE | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), dev_addr, 0U, data, size, result);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_bus_read
+ *******************************************************************************
+ * Summary:
+ *   Performs a read on the bus, or on the replay backend, and records it.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_read
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+static cy_rslt_t regcache_bus_read(cyhal_i2c_t *obj,
+                                   uint16_t dev_addr,
+                                   uint8_t *data,
+                                   uint16_t size,
+                                   uint32_t timeout,
+                                   bool send_stop)
+{
+#if defined(PASCO2_I2C_REPLAY_ENABLED)
+    cy_rslt_t result = pasco2_i2c_replay_transfer(
+        PASCO2_I2C_OP_READ | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), dev_addr, 0U, NULL, data, size);
+#else
+    cy_rslt_t result = __real_cyhal_i2c_master_read(obj, dev_addr, data, size, timeout, send_stop);
+#endif
+    PASCO2_I2C_RECORD(PASCO2_I2C_OP_READ | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), dev_addr, 0U, data, size, result);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_bus_mem_write
+ *******************************************************************************
+ * Summary:
+ *   Performs a memory write on the bus, or on the replay backend, and
+ *   records it.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_mem_write
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+static cy_rslt_t regcache_bus_mem_write(cyhal_i2c_t *obj,
+                                        uint16_t address,
+                                        uint16_t mem_addr,
+                                        uint16_t mem_addr_size,
+                                        const uint8_t *data,
+                                        uint16_t size,
+                                        uint32_t timeout)
+{
+#if defined(PASCO2_I2C_REPLAY_ENABLED)
+    cy_rslt_t result = pasco2_i2c_replay_transfer(PASCO2_I2C_OP_MEM_WRITE, address, mem_addr, data, NULL, size);
+#else
+    cy_rslt_t result = __real_cyhal_i2c_master_mem_write(obj, address, mem_addr, mem_addr_size, data, size, timeout);
+#endif
+    PASCO2_I2C_RECORD(PASCO2_I2C_OP_MEM_WRITE, address, mem_addr, data, size, result);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_bus_mem_read
+ *******************************************************************************
+ * Summary:
+ *   Performs a memory read on the bus, or on the replay backend, and records
+ *   it.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_mem_read
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+static cy_rslt_t regcache_bus_mem_read(cyhal_i2c_t *obj,
+                                       uint16_t address,
+                                       uint16_t mem_addr,
+                                       uint16_t mem_addr_size,
+                                       uint8_t *data,
+                                       uint16_t size,
+                                       uint32_t timeout)
+{
+#if defined(PASCO2_I2C_REPLAY_ENABLED)
+    cy_rslt_t result = pasco2_i2c_replay_transfer(PASCO2_I2C_OP_MEM_READ, address, mem_addr, NULL, data, size);
+#else
+    cy_rslt_t result = __real_cyhal_i2c_master_mem_read(obj, address, mem_addr, mem_addr_size, data, size, timeout);
+#endif
+    PASCO2_I2C_RECORD(PASCO2_I2C_OP_MEM_READ, address, mem_addr, data, size, result);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_range_mask
+ *******************************************************************************
+ * Summary:
+ *   Returns the bit mask of a register range.
+ *
+ * Parameters:
+ *   reg: first register
+ *   size: number of registers
+ *
+ * Return:
+ *   bit mask, 0 if the range exceeds the register map
+ *******************************************************************************/
+static uint32_t regcache_range_mask(uint16_t reg, uint16_t size)
+{
+    if ((size == 0U) || (reg >= PASCO2_REG_COUNT) || (size > (PASCO2_REG_COUNT - reg)))
+    {
+        return 0U;
+    }
+    return ((size >= 32U) ? 0xFFFFFFFFUL : ((1UL << size) - 1UL)) << reg;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_read
+ *******************************************************************************
+ * Summary:
+ *   Serves a register read from the cache if all registers are cached.
+ *
+ * Parameters:
+ *   reg: first register
+ *   data: buffer for the register values
+ *   size: number of registers
+ *
+ * Return:
+ *   true if the read was served from the cache
+ *******************************************************************************/
+static bool regcache_read(uint16_t reg, uint8_t *data, uint16_t size)
+{
+    uint32_t mask = regcache_range_mask(reg, size);
+    if ((mask != 0U) && ((mask & REGCACHE_CACHEABLE & regcache_valid) == mask))
+    {
+        memcpy(data, &regcache_values[reg], size);
+        regcache_statistics.read_hits++;
+        return true;
+    }
+    if ((mask & REGCACHE_CACHEABLE) != 0U)
+    {
+        regcache_statistics.read_misses++;
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_write_unchanged
+ *******************************************************************************
+ * Summary:
+ *   Checks whether a register write would leave all registers unchanged.
+ *
+ * Parameters:
+ *   reg: first register
+ *   data: register values
+ *   size: number of registers
+ *
+ * Return:
+ *   true if the write can be skipped
+ *******************************************************************************/
+static bool regcache_write_unchanged(uint16_t reg, const uint8_t *data, uint16_t size)
+{
+    uint32_t mask = regcache_range_mask(reg, size);
+    if ((mask != 0U) && ((mask & REGCACHE_CACHEABLE & regcache_valid) == mask) &&
+        (memcmp(&regcache_values[reg], data, size) == 0))
+    {
+        regcache_statistics.writes_skipped++;
+        return true;
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: regcache_update
+ *******************************************************************************
+ * Summary:
+ *   Stores register values transferred on the bus. A write to SENS_RST resets
+ *   the sensor and invalidates the cache.
+ *
+ * Parameters:
+ *   reg: first register
+ *   data: register values
+ *   size: number of registers
+ *   write: values were written to the sensor
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void regcache_update(uint16_t reg, const uint8_t *data, uint16_t size, bool write)
+{
+    uint32_t mask = regcache_range_mask(reg, size);
+    if (write && ((mask & (1UL << PASCO2_REG_SENS_RST)) != 0U))
+    {
+        pasco2_regcache_invalidate();
+        return;
+    }
+    for (uint16_t i = 0; (mask != 0U) && (i < size); i++)
+    {
+        if ((REGCACHE_CACHEABLE & (1UL << (reg + i))) != 0U)
+        {
+            regcache_values[reg + i] = data[i];
+            regcache_valid |= (1UL << (reg + i));
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: regcache_bus_result
+ *******************************************************************************
+ * Summary:
+ *   Counts a bus transaction and invalidates the cache if it failed.
+ *
+ * Parameters:
+ *   result: result of the transaction
+ *
+ * Return:
+ *   result
+ *******************************************************************************/
+static cy_rslt_t regcache_bus_result(cy_rslt_t result)
+{
+    regcache_statistics.bus_transactions++;
+    if (result != CY_RSLT_SUCCESS)
+    {
+        pasco2_regcache_invalidate();
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_regcache_invalidate
+ *******************************************************************************
+ * Summary:
+ *   Drops all cached register values, e.g. after a sensor reset or a
+ *   communication error.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_regcache_invalidate(void)
+{
+    regcache_valid = 0;
+    regcache_pointer.valid = false;
+    regcache_statistics.invalidations++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_regcache_get_statistics
+ *******************************************************************************
+ * Summary:
+ *   Returns the cache and bus counters.
+ *
+ * Parameters:
+ *   statistics: counters
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_regcache_get_statistics(pasco2_regcache_statistics_t *statistics)
+{
+    *statistics = regcache_statistics;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_regcache_print_statistics
+ *******************************************************************************
+ * Summary:
+ *   Prints the cache and bus counters.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_regcache_print_statistics(void)
+{
+    pasco2_printf("Register cache: %u hits, %u misses, %u writes skipped, %u invalidations\r\n",
+                  (unsigned int)regcache_statistics.read_hits,
+                  (unsigned int)regcache_statistics.read_misses,
+                  (unsigned int)regcache_statistics.writes_skipped,
+                  (unsigned int)regcache_statistics.invalidations);
+    pasco2_printf("I2C transactions to the sensor: %u\r\n\r\n", (unsigned int)regcache_statistics.bus_transactions);
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cyhal_i2c_master_write
+ *******************************************************************************
+ * Summary:
+ *   Replaces cyhal_i2c_master_write. For the sensor, the first byte is the
+ *   register address. An address without data is sent to the sensor and
+ *   remembered for the next read, writes of unchanged cached values are
+ *   skipped.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_write
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+cy_rslt_t __wrap_cyhal_i2c_master_write(cyhal_i2c_t *obj,
+                                        uint16_t dev_addr,
+                                        const uint8_t *data,
+                                        uint16_t size,
+                                        uint32_t timeout,
+                                        bool send_stop)
+{
+    if ((dev_addr != PASCO2_REGCACHE_I2C_ADDRESS) || (size == 0U))
+    {
+        return regcache_bus_write(obj, dev_addr, data, size, timeout, send_stop);
+    }
+
+    /* The address pointer is always sent, so that a NAK reaches the driver */
+    regcache_pointer.valid = false;
+    if ((size > 1U) && regcache_write_unchanged(data[0], &data[1], size - 1U))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+    cy_rslt_t result = regcache_bus_result(regcache_bus_write(obj, dev_addr, data, size, timeout, send_stop));
+    if ((result == CY_RSLT_SUCCESS) && (size == 1U))
+    {
+        regcache_pointer.valid = true;
+        regcache_pointer.reg = data[0];
+    }
+    else if (result == CY_RSLT_SUCCESS)
+    {
+        regcache_update(data[0], &data[1], size - 1U, true);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cyhal_i2c_master_read
+ *******************************************************************************
+ * Summary:
+ *   Replaces cyhal_i2c_master_read. Reads of cached sensor registers at the
+ *   address sent before are served locally.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_read
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+cy_rslt_t __wrap_cyhal_i2c_master_read(cyhal_i2c_t *obj,
+                                       uint16_t dev_addr,
+                                       uint8_t *data,
+                                       uint16_t size,
+                                       uint32_t timeout,
+                                       bool send_stop)
+{
+    if (dev_addr != PASCO2_REGCACHE_I2C_ADDRESS)
+    {
+        return regcache_bus_read(obj, dev_addr, data, size, timeout, send_stop);
+    }
+
+    /* The address pointer of the sensor is only known for the first read
+     * after it was set */
+    bool known_reg = regcache_pointer.valid;
+    uint8_t reg = regcache_pointer.reg;
+    regcache_pointer.valid = false;
+    if (known_reg && regcache_read(reg, data, size))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    cy_rslt_t result = regcache_bus_result(regcache_bus_read(obj, dev_addr, data, size, timeout, send_stop));
+    if (known_reg && (result == CY_RSLT_SUCCESS))
+    {
+        regcache_update(reg, data, size, false);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cyhal_i2c_master_mem_write
+ *******************************************************************************
+ * Summary:
+ *   Replaces cyhal_i2c_master_mem_write. Writes of unchanged cached sensor
+ *   registers are skipped.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_mem_write
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+cy_rslt_t __wrap_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout)
+{
+    if ((address != PASCO2_REGCACHE_I2C_ADDRESS) || (mem_addr_size != 1U))
+    {
+        return regcache_bus_mem_write(obj, address, mem_addr, mem_addr_size, data, size, timeout);
+    }
+
+    regcache_pointer.valid = false;
+    if (regcache_write_unchanged(mem_addr, data, size))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+    cy_rslt_t result = regcache_bus_result(
+        regcache_bus_mem_write(obj, address, mem_addr, mem_addr_size, data, size, timeout));
+    if (result == CY_RSLT_SUCCESS)
+    {
+        regcache_update(mem_addr, data, size, true);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cyhal_i2c_master_mem_read
+ *******************************************************************************
+ * Summary:
+ *   Replaces cyhal_i2c_master_mem_read. Reads of cached sensor registers are
+ *   served locally.
+ *
+ * Parameters:
+ *   see cyhal_i2c_master_mem_read
+ *
+ * Return:
+ *   Status of the I2C transaction
+ *******************************************************************************/
+cy_rslt_t __wrap_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout)
+{
+    if ((address != PASCO2_REGCACHE_I2C_ADDRESS) || (mem_addr_size != 1U))
+    {
+        return regcache_bus_mem_read(obj, address, mem_addr, mem_addr_size, data, size, timeout);
+    }
+
+    regcache_pointer.valid = false;
+    if (regcache_read(mem_addr, data, size))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+    cy_rslt_t result = regcache_bus_result(
+        regcache_bus_mem_read(obj, address, mem_addr, mem_addr_size, data, size, timeout));
+    if (result == CY_RSLT_SUCCESS)
+    {
+        regcache_update(mem_addr, data, size, false);
+    }
+    return result;
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+** File name: pasco2_regcache.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_regcache.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* 7 bit I2C address of the PAS CO2 sensor */
+#define PASCO2_REGCACHE_I2C_ADDRESS (0x28U)
+
+/* PAS CO2 register addresses */
+#define PASCO2_REG_PROD_ID     (0x00U)
+#define PASCO2_REG_SENS_STS    (0x01U)
+#define PASCO2_REG_MEAS_RATE_H (0x02U)
+#define PASCO2_REG_MEAS_RATE_L (0x03U)
+#define PASCO2_REG_MEAS_CFG    (0x04U)
+#define PASCO2_REG_CO2PPM_H    (0x05U)
+#define PASCO2_REG_CO2PPM_L    (0x06U)
+#define PASCO2_REG_MEAS_STS    (0x07U)
+#define PASCO2_REG_INT_CFG     (0x08U)
+#define PASCO2_REG_ALARM_TH_H  (0x09U)
+#define PASCO2_REG_ALARM_TH_L  (0x0AU)
+#define PASCO2_REG_PRESS_REF_H (0x0BU)
+#define PASCO2_REG_PRESS_REF_L (0x0CU)
+#define PASCO2_REG_CALIB_REF_H (0x0DU)
+#define PASCO2_REG_CALIB_REF_L (0x0EU)
+#define PASCO2_REG_SCRATCH_PAD (0x0FU)
+#define PASCO2_REG_SENS_RST    (0x10U)
+#define PASCO2_REG_COUNT       (0x11U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t bus_transactions; /* I2C transfers to the sensor on the bus */
+    uint32_t read_hits;        /* register reads served from the cache */
+    uint32_t read_misses;      /* register reads of cacheable registers from the bus */
+    uint32_t writes_skipped;   /* register writes of unchanged values */
+    uint32_t invalidations;    /* cache invalidations */
+} pasco2_regcache_statistics_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_regcache_invalidate(void);
+void pasco2_regcache_get_statistics(pasco2_regcache_statistics_t *statistics);
+void pasco2_regcache_print_statistics(void);
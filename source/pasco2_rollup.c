@@ -0,0 +1,264 @@
+/*****************************************************************************
+** File name: pasco2_rollup.c
+**
+** Description: This file keeps minute, hour and day aggregates of the CO2
+** samples in fixed size ring tables. Every sample updates the current bucket
+** of each resolution, a range query combines the buckets of the finest
+** resolution which covers the range. The tables are only accessed from
+** executor jobs and need no locking.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "pasco2_print.h"
+#include "pasco2_rollup.h"
+
+/*******************************************************************************
+ * Constants
+ *******************************************************************************/
+#define ROLLUP_LEVEL_COUNT (3U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t index; /* bucket number since boot, start time / length */
+    uint32_t sum;
+    uint32_t count; /* 0 if the bucket is empty */
+    uint16_t min;
+    uint16_t max;
+} rollup_bucket_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t length; /* bucket length in s */
+    uint32_t size;   /* number of buckets */
+    rollup_bucket_t *buckets;
+} rollup_level_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static rollup_bucket_t rollup_minutes[PASCO2_ROLLUP_MINUTES];
+static rollup_bucket_t rollup_hours[PASCO2_ROLLUP_HOURS];
+static rollup_bucket_t rollup_days[PASCO2_ROLLUP_DAYS];
+
+/* Ordered from the finest to the coarsest resolution */
+static const rollup_level_t rollup_levels[ROLLUP_LEVEL_COUNT] = {
+    {"minute", 60U, PASCO2_ROLLUP_MINUTES, rollup_minutes},
+    {"hour", 3600U, PASCO2_ROLLUP_HOURS, rollup_hours},
+    {"day", 86400U, PASCO2_ROLLUP_DAYS, rollup_days},
+};
+
+/* Seconds since boot, kept separately as the RTOS time in ms wraps after
+ * 49 days */
+static uint32_t rollup_seconds = 0;
+static uint32_t rollup_remainder = 0;
+static cy_time_t rollup_last = 0;
+
+/*******************************************************************************
+ * Function Name: rollup_clock
+ *******************************************************************************
+ * Summary:
+ *   Advances the time since boot by the RTOS time elapsed since the last call.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   time since boot in s
+ *******************************************************************************/
+static uint32_t rollup_clock(void)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+
+    rollup_remainder += (uint32_t)(now - rollup_last);
+    rollup_last = now;
+    rollup_seconds += rollup_remainder / 1000U;
+    rollup_remainder %= 1000U;
+    return rollup_seconds;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rollup_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a CO2 sample to the current bucket of every resolution. A bucket
+ *   which still holds an older period is cleared first.
+ *
+ * Parameters:
+ *   ppm: CO2 value in ppm
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_rollup_add(uint16_t ppm)
+{
+    uint32_t now = rollup_clock();
+
+    for (uint32_t i = 0; i < ROLLUP_LEVEL_COUNT; i++)
+    {
+        const rollup_level_t *level = &rollup_levels[i];
+        uint32_t index = now / level->length;
+        rollup_bucket_t *bucket = &level->buckets[index % level->size];
+
+        if ((bucket->count == 0U) || (bucket->index != index))
+        {
+            bucket->index = index;
+            bucket->sum = 0;
+            bucket->count = 0;
+            bucket->min = ppm;
+            bucket->max = ppm;
+        }
+        bucket->sum += ppm;
+        bucket->count++;
+        if (ppm < bucket->min)
+        {
+            bucket->min = ppm;
+        }
+        if (ppm > bucket->max)
+        {
+            bucket->max = ppm;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rollup_query
+ *******************************************************************************
+ * Summary:
+ *   Aggregates the samples of the last range_s seconds. The finest resolution
+ *   whose table covers the range is used, so at most PASCO2_ROLLUP_MINUTES
+ *   buckets are read. The oldest bucket is included completely, the result
+ *   may therefore contain samples up to one bucket length older than the
+ *   range. Ranges longer than the day table are shortened to it.
+ *
+ * Parameters:
+ *   range_s: time range in s, ending now
+ *   result: aggregate of the range
+ *
+ * Return:
+ *   true if the range contains samples
+ *******************************************************************************/
+bool pasco2_rollup_query(uint32_t range_s, pasco2_rollup_result_t *result)
+{
+    uint32_t now = rollup_clock();
+    uint32_t start = (range_s < now) ? (now - range_s) : 0U;
+
+    const rollup_level_t *level = &rollup_levels[0];
+    for (uint32_t i = 0; i < ROLLUP_LEVEL_COUNT; i++)
+    {
+        level = &rollup_levels[i];
+        if (((now / level->length) - (start / level->length)) < level->size)
+        {
+            break;
+        }
+    }
+
+    uint32_t last = now / level->length;
+    uint32_t first = start / level->length;
+    if ((last - first) >= level->size)
+    {
+        first = last - (level->size - 1U);
+    }
+
+    /* A day bucket stays below 2^32, the sum of all of them does not */
+    uint64_t sum = 0;
+    *result = (pasco2_rollup_result_t){
+        .min = UINT16_MAX,
+        .resolution = level->length,
+    };
+    for (uint32_t index = first; index <= last; index++)
+    {
+        const rollup_bucket_t *bucket = &level->buckets[index % level->size];
+        result->buckets++;
+        if ((bucket->count == 0U) || (bucket->index != index))
+        {
+            continue;
+        }
+        sum += bucket->sum;
+        result->count += bucket->count;
+        if (bucket->min < result->min)
+        {
+            result->min = bucket->min;
+        }
+        if (bucket->max > result->max)
+        {
+            result->max = bucket->max;
+        }
+    }
+
+    uint32_t covered = now - (first * level->length);
+    result->range = (range_s < covered) ? range_s : covered;
+    if (result->count == 0U)
+    {
+        result->min = 0;
+        return false;
+    }
+    result->mean = (uint16_t)((sum + (result->count / 2U)) / result->count);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rollup_print_query
+ *******************************************************************************
+ * Summary:
+ *   Prints the aggregate of the samples of the last range_s seconds.
+ *
+ * Parameters:
+ *   range_s: time range in s, ending now
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_rollup_print_query(uint32_t range_s)
+{
+    pasco2_rollup_result_t result;
+    bool found = pasco2_rollup_query(range_s, &result);
+
+    const char *resolution = rollup_levels[0].name;
+    for (uint32_t i = 0; i < ROLLUP_LEVEL_COUNT; i++)
+    {
+        if (rollup_levels[i].length == result.resolution)
+        {
+            resolution = rollup_levels[i].name;
+        }
+    }
+
+    pasco2_printf("Range: %u s (%u %s buckets)\r\n",
+                  (unsigned int)result.range,
+                  (unsigned int)result.buckets,
+                  resolution);
+    if (!found)
+    {
+        pasco2_printf("No CO2 samples in range\r\n\r\n");
+        return;
+    }
+    pasco2_printf("Samples: %u\r\n", (unsigned int)result.count);
+    pasco2_printf("Min: %u ppm\r\n", (unsigned int)result.min);
+    pasco2_printf("Max: %u ppm\r\n", (unsigned int)result.max);
+    pasco2_printf("Mean: %u ppm\r\n\r\n", (unsigned int)result.mean);
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+** File name: pasco2_rollup.h
+**
+** Description: This file contains the function prototypes and constants used
+**   in pasco2_rollup.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of buckets kept per resolution. A range which does not start on a
+ * bucket boundary touches one bucket more than its length, so 2 hours are
+ * answered from minutes, 48 hours from hours and 31 days from days. */
+#define PASCO2_ROLLUP_MINUTES (121U)
+#define PASCO2_ROLLUP_HOURS   (49U)
+#define PASCO2_ROLLUP_DAYS    (32U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t count;      /* number of samples */
+    uint16_t min;        /* lowest CO2 value in ppm */
+    uint16_t max;        /* highest CO2 value in ppm */
+    uint16_t mean;       /* mean CO2 value in ppm */
+    uint32_t resolution; /* bucket length in s used to answer the query */
+    uint32_t range;      /* covered time range in s, may be shorter than requested */
+    uint32_t buckets;    /* number of buckets read */
+} pasco2_rollup_result_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_rollup_add(uint16_t ppm);
+bool pasco2_rollup_query(uint32_t range_s, pasco2_rollup_result_t *result);
+void pasco2_rollup_print_query(uint32_t range_s);
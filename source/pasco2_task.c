@@ -23,37 +23,69 @@
 ** ===========================================================================
 */
 
-/* Header file from system */
-#include <stdio.h>
-
 /* Header file includes */
 #include "cybsp.h"
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "pasco2_adaptive_period.h"
+#include "pasco2_board.h"
+#include "pasco2_config_store.h"
+#include "pasco2_executor.h"
+#include "pasco2_health.h"
+#include "pasco2_i2c_record.h"
+#include "pasco2_pool.h"
+#include "pasco2_print.h"
+#include "pasco2_regcache.h"
+#include "pasco2_rollup.h"
 #include "pasco2_task.h"
+#include "pasco2_trace.h"
+
+/* Time in ms for the sensor to power up */
+#define PASCO2_POWER_UP_DELAY (2000U)
+
+/* Events of the LED job */
+#define LED_EVENT_READY       (PASCO2_EXECUTOR_EVENT_USER << 0)
+#define LED_EVENT_WARNING_ON  (PASCO2_EXECUTOR_EVENT_USER << 1)
+#define LED_EVENT_WARNING_OFF (PASCO2_EXECUTOR_EVENT_USER << 2)
+/* Events of the log job */
+#define LOG_EVENT_MESSAGE (PASCO2_EXECUTOR_EVENT_USER << 0)
+/* Events of the sensor job */
+#define SENSOR_EVENT_PERIOD (PASCO2_EXECUTOR_EVENT_USER << 0)
+
+/* Number of sensor messages which can wait for the log job */
+#define SENSOR_MESSAGE_COUNT (4U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Resume points of the sensor job */
+typedef enum
+{
+    SENSOR_STATE_POWER_UP,
+    SENSOR_STATE_INIT,
+    SENSOR_STATE_MEASURE,
+} sensor_state_t;
+
+typedef enum
+{
+    SENSOR_MESSAGE_SAMPLE,
+    SENSOR_MESSAGE_PERIOD,
+    SENSOR_MESSAGE_REQUEST,
+    SENSOR_MESSAGE_ADAPTIVE_OFF,
+} sensor_message_type_t;
+
+/* Sample, period change or outcome of a request of the terminal UI passed
+ * from the sensor job to the log job, which prints it */
+typedef struct sensor_message
+{
+    struct sensor_message *next;
+    sensor_message_type_t type;
+    cy_rslt_t result;
+    uint16_t ppm;
+    uint16_t period;
+} sensor_message_t;
 
-/* Output pin for sensor PSEL line */
-#define MTB_PASCO2_PSEL (P5_3)
-/* Pin state to enable I2C channel of sensor */
-#define MTB_PASCO2_PSEL_I2C_ENABLE (0U)
-/* Output pin for PAS CO2 Wing Board power switch */
-#define MTB_PASCO2_POWER_SWITCH (P10_5)
-/* Pin state to enable power to sensor on PAS CO2 Wing Board*/
-#define MTB_PASCO2_POWER_ON (1U)
-
-/* Output pin for PAS CO2 Wing Board LED OK */
-#define MTB_PASCO2_LED_OK (P9_0)
-/* Output pin for PAS CO2 Wing Board LED WARNING  */
-#define MTB_PASCO2_LED_WARNING (P9_1)
-
-/* Pin state for PAS CO2 Wing Board LED off. */
-#define MTB_PASCO_LED_STATE_OFF (0U)
-/* Pin state for PAS CO2 Wing Board LED on. */
-#define MTB_PASCO_LED_STATE_ON (1U)
-
-/* I2C bus frequency */
-#define I2C_MASTER_FREQUENCY (100000U)
 /*******************************************************************************
  * Global Variables
  ******************************************************************************/
@@ -63,117 +95,314 @@ mtb_pasco2_context_t mtb_pasco2_context;
 
 static volatile bool log_internal = false;
 static volatile bool display_ppm = true;
+static volatile bool adaptive_period = false;
+
+/* I2C object used by the CO2 driver */
+static cyhal_i2c_t cyhal_i2c;
+
+/* Adaptive measurement period state */
+static pasco2_adaptive_period_t adaptive_ctrl;
+static bool adaptive_active = false;
+static uint16_t applied_period = 0;
+/* Fixed period set by the user, applied again when adaptation ends */
+static uint16_t configured_period = PASCO2_MEASUREMENT_PERIOD_DEFAULT;
+static cy_time_t last_sample_time = 0;
+/* Measurement period requested by the terminal UI, 0 if none is pending */
+static volatile uint16_t requested_period = 0;
 
-static cy_mutex_t terminal_print_mutex;
+/* Messages from the sensor job waiting for the log job, oldest first */
+PASCO2_POOL_DEFINE(sensor_message_pool, sizeof(sensor_message_t), SENSOR_MESSAGE_COUNT);
+static sensor_message_t *sensor_message_head = NULL;
+static sensor_message_t *sensor_message_tail = NULL;
+
+static void sensor_job_run(pasco2_job_t *job, uint32_t events);
+static void led_job_run(pasco2_job_t *job, uint32_t events);
+static void log_job_run(pasco2_job_t *job, uint32_t events);
+
+static pasco2_job_t sensor_job = {.name = "CO2 sensor", .handler = sensor_job_run};
+static pasco2_job_t led_job = {.name = "LED", .handler = led_job_run};
+static pasco2_job_t log_job = {.name = "log", .handler = log_job_run};
 
 #define conditional_log(...)                                                                                           \
     if (log_internal)                                                                                                  \
     {                                                                                                                  \
-        printf(__VA_ARGS__);                                                                                           \
+        pasco2_printf(__VA_ARGS__);                                                                                    \
     }
 
 /*******************************************************************************
- * Function Name: pasco2_terminal_mutex_get
+ * Function Name: pasco2_enable_internal_logging
  *******************************************************************************
  * Summary:
- *   Get mutex
+ *  enable/disable debug info for CO2 sensor
  *
  * Parameters:
- *   timeout_ms: Maximum number of milliseconds to wait while attempting to
- *   get mutex
+ *   enable_logging: value for logging flag
+ *
  *
  * Return:
  *   Status of mutex request
  *******************************************************************************/
-cy_rslt_t pasco2_terminal_mutex_get(cy_time_t timeout_ms)
+void pasco2_enable_internal_logging(bool enable_logging)
 {
-    return (cy_rtos_get_mutex(&terminal_print_mutex, timeout_ms));
+    if (enable_logging)
+    {
+        pasco2_printf("Enable additional diagnostic logging\r\n\r\n");
+    }
+    else
+    {
+        pasco2_printf("Disable additional diagnostic logging\r\n\r\n");
+    }
+    log_internal = enable_logging;
 }
 
 /*******************************************************************************
- * Function Name: pasco2_terminal_mutex_release
+ * Function Name: pasco2_display_ppm
  *******************************************************************************
  * Summary:
- *  Set mutex
+ *   Enables serial printing of CO2 PPM value
  *
  * Parameters:
- *   none
+ *   enable_output: enables printing of CO2 value
  *
  * Return:
- *   Status of mutex request
+ *   system time in ms
  *******************************************************************************/
-cy_rslt_t pasco2_terminal_mutex_release(void)
+void pasco2_display_ppm(bool enable_output)
 {
-    return (cy_rtos_set_mutex(&terminal_print_mutex));
+    display_ppm = enable_output;
 }
 
 /*******************************************************************************
- * Function Name: pasco2_enable_internal_logging
+ * Function Name: pasco2_enable_adaptive_period
  *******************************************************************************
  * Summary:
- *  enable/disable debug info for CO2 sensor
+ *   enable/disable adaptation of the measurement period to the CO2 rate of
+ *   change
  *
  * Parameters:
- *   enable_logging: value for logging flag
+ *   enable_adaptive: value for adaptive period flag
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_enable_adaptive_period(bool enable_adaptive)
+{
+    if (enable_adaptive)
+    {
+        pasco2_printf("Enable adaptive measurement period [%u-%u]s\r\n\r\n",
+                      PASCO2_ADAPTIVE_PERIOD_MIN,
+                      PASCO2_ADAPTIVE_PERIOD_MAX);
+    }
+    else
+    {
+        pasco2_printf("Disable adaptive measurement period\r\n\r\n");
+    }
+    adaptive_period = enable_adaptive;
+}
+
+/*******************************************************************************
+ * Function Name: sensor_message_post
+ *******************************************************************************
+ * Summary:
+ *   Passes a sample or period change to the log job. The message is dropped
+ *   if the log job lags SENSOR_MESSAGE_COUNT messages behind, the pool
+ *   statistics count these failures.
  *
+ * Parameters:
+ *   type: message type
+ *   result: result of the sensor read
+ *   ppm: CO2 value
+ *   period: measurement period in s
  *
  * Return:
- *   Status of mutex request
+ *   none
  *******************************************************************************/
-void pasco2_enable_internal_logging(bool enable_logging)
+static void sensor_message_post(sensor_message_type_t type, cy_rslt_t result, uint16_t ppm, uint16_t period)
 {
-    if (enable_logging)
+    sensor_message_t *message = pasco2_pool_alloc(&sensor_message_pool);
+    if (message == NULL)
+    {
+        return;
+    }
+    message->next = NULL;
+    message->type = type;
+    message->result = result;
+    message->ppm = ppm;
+    message->period = period;
+
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    if (sensor_message_tail != NULL)
     {
-        printf("Enable additional diagnostic logging\r\n\r\n");
+        sensor_message_tail->next = message;
     }
     else
     {
-        printf("Disable additional diagnostic logging\r\n\r\n");
+        sensor_message_head = message;
     }
-    log_internal = enable_logging;
+    sensor_message_tail = message;
+    cyhal_system_critical_section_exit(interrupt_state);
+
+    pasco2_executor_signal(&log_job, LOG_EVENT_MESSAGE);
 }
 
 /*******************************************************************************
- * Function Name: pasco2_display_ppm
+ * Function Name: sensor_message_take
  *******************************************************************************
  * Summary:
- *   Enables serial printing of CO2 PPM value
+ *   Removes the oldest message of the sensor job. The caller returns it to
+ *   sensor_message_pool.
  *
  * Parameters:
- *   enable_output: enables printing of CO2 value
+ *   none
  *
  * Return:
- *   system time in ms
+ *   oldest message, NULL if there is none
  *******************************************************************************/
-void pasco2_display_ppm(bool enable_output)
+static sensor_message_t *sensor_message_take(void)
 {
-    display_ppm = enable_output;
+    uint32_t interrupt_state = cyhal_system_critical_section_enter();
+    sensor_message_t *message = sensor_message_head;
+    if (message != NULL)
+    {
+        sensor_message_head = message->next;
+        if (sensor_message_head == NULL)
+        {
+            sensor_message_tail = NULL;
+        }
+    }
+    cyhal_system_critical_section_exit(interrupt_state);
+    return message;
+}
+
+/*******************************************************************************
+ * Function Name: sensor_set_period
+ *******************************************************************************
+ * Summary:
+ *   Sets a fixed measurement period of the sensor. It is applied again when
+ *   the adaptive mode is disabled.
+ *
+ * Parameters:
+ *   period: measurement period in s
+ *
+ * Return:
+ *   Status of the sensor configuration
+ *******************************************************************************/
+static cy_rslt_t sensor_set_period(uint16_t period)
+{
+    mtb_pasco2_config_t pas_co2_config = {
+        .measurement_period = period,
+    };
+    PASCO2_TRACE_SPAN_BEGIN(PASCO2_TRACE_SPAN_SET_CONFIG);
+    cy_rslt_t result = mtb_pasco2_set_config(&mtb_pasco2_context, &pas_co2_config);
+    PASCO2_TRACE_SPAN_END(PASCO2_TRACE_SPAN_SET_CONFIG, CY_RSLT_GET_CODE(result));
+    if (result == CY_RSLT_SUCCESS)
+    {
+        configured_period = period;
+    }
+    return result;
 }
 
 /*******************************************************************************
- * Function Name: pasco2_task
+ * Function Name: pasco2_request_measurement_period
  *******************************************************************************
  * Summary:
- *   Initializes context object of PASCO2 library, sets default parameters values
- *   for sensor and continuously acquire data from sensor.
+ *   Requests a fixed measurement period. The sensor job writes it to the
+ *   sensor, so that the caller does not wait for the I2C transfers, and the
+ *   log job prints the outcome. A fixed period disables the adaptive mode
+ *   and is saved in the configuration store.
  *
  * Parameters:
- *   arg: thread
+ *   period: measurement period in s
  *
  * Return:
  *   none
  *******************************************************************************/
-void pasco2_task(cy_thread_arg_t arg)
+void pasco2_request_measurement_period(uint16_t period)
+{
+    requested_period = period;
+    pasco2_executor_signal(&sensor_job, SENSOR_EVENT_PERIOD);
+}
+
+/*******************************************************************************
+ * Function Name: sensor_apply_request
+ *******************************************************************************
+ * Summary:
+ *   Writes a measurement period requested by the terminal UI to the sensor.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void sensor_apply_request(void)
+{
+    uint16_t period = requested_period;
+    if (period == 0U)
+    {
+        return;
+    }
+    requested_period = 0;
+
+    bool was_adaptive = adaptive_period;
+    cy_rslt_t result = sensor_set_period(period);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        /* A fixed period overrides the adaptive period */
+        adaptive_period = false;
+        adaptive_active = false;
+        pasco2_config_store_set_measurement_period(period);
+        pasco2_config_store_set_adaptive_period(false);
+    }
+    sensor_message_post(SENSOR_MESSAGE_REQUEST, result, 0U, period);
+    if ((result == CY_RSLT_SUCCESS) && was_adaptive)
+    {
+        sensor_message_post(SENSOR_MESSAGE_ADAPTIVE_OFF, result, 0U, period);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sensor_job_wait
+ *******************************************************************************
+ * Summary:
+ *   Writes pending configuration changes, reports a heartbeat to the health
+ *   monitor and resumes the sensor job after a delay.
+ *
+ * Parameters:
+ *   job: sensor job
+ *   delay_ms: time until the next measurement in ms
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void sensor_job_wait(pasco2_job_t *job, uint32_t delay_ms)
+{
+    pasco2_config_store_process();
+    pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, delay_ms);
+    pasco2_executor_schedule(job, delay_ms);
+}
+
+/*******************************************************************************
+ * Function Name: sensor_power_up
+ *******************************************************************************
+ * Summary:
+ *   Initializes the I2C bus and powers up the PAS CO2 Wing Board.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void sensor_power_up(void)
 {
     cy_rslt_t result;
-    /* I2C variables */
-    cyhal_i2c_t cyhal_i2c;
     /* initialize i2c library*/
     cyhal_i2c_cfg_t i2c_master_config = {CYHAL_I2C_MODE_MASTER,
                                          0 /* address is not used for master mode */,
                                          I2C_MASTER_FREQUENCY};
 
-    result = cyhal_i2c_init(&cyhal_i2c, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL);
+    result = cyhal_i2c_init(&cyhal_i2c, MTB_PASCO2_I2C_SDA, MTB_PASCO2_I2C_SCL, NULL);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
@@ -184,119 +413,472 @@ void pasco2_task(cy_thread_arg_t arg)
         CY_ASSERT(0);
     }
 
-    /* initialize mutex for terminal print */
-    result = cy_rtos_init_mutex(&terminal_print_mutex);
-    if (result != CY_RSLT_SUCCESS)
+    /* Initialize and enable PAS CO2 Wing Board power switch */
+    if (MTB_PASCO2_POWER_SWITCH != NC)
     {
-        CY_ASSERT(0);
+        cyhal_gpio_init(MTB_PASCO2_POWER_SWITCH, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_POWER_ON);
     }
-
-    /* Initialize the User LED on CYSBSYSKIT-DEV-01 and turn it on to show initialization of PAS CO2 Wing Board */
-    result = cyhal_gpio_init(CYBSP_USER_LED, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_ON);
-    if (result != CY_RSLT_SUCCESS)
+    /* Initialize and enable PAS CO2 Wing Board I2C channel communication*/
+    if (MTB_PASCO2_PSEL != NC)
     {
-        CY_ASSERT(0);
+        cyhal_gpio_init(MTB_PASCO2_PSEL, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_PSEL_I2C_ENABLE);
     }
+}
 
-    /* Initialize and enable PAS CO2 Wing Board power switch */
-    cyhal_gpio_init(MTB_PASCO2_POWER_SWITCH, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_POWER_ON);
-    /* Initialize and enable PAS CO2 Wing Board I2C channel communication*/
-    cyhal_gpio_init(MTB_PASCO2_PSEL, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_PSEL_I2C_ENABLE);
-    /* Initialize the LEDs on PAS CO2 Wing Board */
-    cyhal_gpio_init(MTB_PASCO2_LED_OK, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
-    cyhal_gpio_init(MTB_PASCO2_LED_WARNING, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
-
-    vTaskDelay(2000);
-
+/*******************************************************************************
+ * Function Name: sensor_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the PAS CO2 sensor and restores the configuration saved
+ *   before the last reset.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void sensor_init(void)
+{
     /* Initialize PAS CO2 sensor with default parameter values */
-    result = mtb_pasco2_init(&mtb_pasco2_context, &cyhal_i2c);
+    PASCO2_TRACE_SPAN_BEGIN(PASCO2_TRACE_SPAN_SENSOR_INIT);
+    cy_rslt_t result = mtb_pasco2_init(&mtb_pasco2_context, &cyhal_i2c);
+    PASCO2_TRACE_SPAN_END(PASCO2_TRACE_SPAN_SENSOR_INIT, CY_RSLT_GET_CODE(result));
     if (result != CY_RSLT_SUCCESS)
     {
         /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-        printf("\x1b[2J\x1b[;H");
+        pasco2_printf("\x1b[2J\x1b[;H");
         if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_SENSOR_NOT_FOUND)
         {
-            printf("****************** "
-                   "PAS CO2 Wing Board not found "
-                   "****************** \r\n\n");
+            pasco2_printf("****************** "
+                          "PAS CO2 Wing Board not found "
+                          "****************** \r\n\n");
         }
         else
         {
-            printf("An unexpected occurred during initialization of CO2 sensor\r\n");
+            pasco2_printf("An unexpected occurred during initialization of CO2 sensor\r\n");
         }
         CY_ASSERT(0);
     }
-    /* Turn off User LED on CYSBSYSKIT-DEV-01 to indicate successful initialization of CO2 Wing Board */
-    cyhal_gpio_write(CYBSP_USER_LED, CYBSP_LED_STATE_OFF);
-    /* Turn on status LED on PAS CO2 Wing Board to indicate normal operation */
-    cyhal_gpio_write(MTB_PASCO2_LED_OK, MTB_PASCO_LED_STATE_ON);
-    for (;;)
+    /* Restore the configuration saved before the last reset */
+    pasco2_config_store_data_t stored_config;
+    if ((pasco2_config_store_init() == CY_RSLT_SUCCESS) && pasco2_config_store_get(&stored_config))
     {
-        uint16_t ppm = 0;
-
-        /* Read CO2 value from sensor */
-        result = mtb_pasco2_get_ppm(&mtb_pasco2_context, &ppm);
-        pasco2_terminal_mutex_get(0);
+        if ((stored_config.measurement_period != 0U) &&
+            (sensor_set_period(stored_config.measurement_period) == CY_RSLT_SUCCESS))
+        {
+            pasco2_printf("CO2 measurement period restored to: %d\r\n\r\n", stored_config.measurement_period);
+        }
+        if (stored_config.adaptive_period != 0U)
+        {
+            pasco2_enable_adaptive_period(true);
+        }
+    }
+}
 
+/*******************************************************************************
+ * Function Name: sensor_adapt_period
+ *******************************************************************************
+ * Summary:
+ *   Adapts the measurement period to the CO2 rate of change. If the sensor
+ *   rejects a new period, the previous one stays in use.
+ *
+ * Parameters:
+ *   ppm: new CO2 value
+ *
+ * Return:
+ *   time until the next measurement in ms
+ *******************************************************************************/
+static uint32_t sensor_adapt_period(uint16_t ppm)
+{
+    cy_time_t now;
+    cy_rtos_get_time(&now);
+    if (!adaptive_active)
+    {
+        pasco2_adaptive_period_init(&adaptive_ctrl, NULL, PASCO2_ADAPTIVE_PERIOD_MIN);
+        applied_period = 0;
+        adaptive_active = true;
+    }
+    uint16_t period = pasco2_adaptive_period_update(&adaptive_ctrl, ppm, (uint32_t)(now - last_sample_time));
+    last_sample_time = now;
+    if (period != applied_period)
+    {
+        mtb_pasco2_config_t pas_co2_config = {
+            .measurement_period = period,
+        };
+        PASCO2_TRACE_SPAN_BEGIN(PASCO2_TRACE_SPAN_SET_CONFIG);
+        cy_rslt_t result = mtb_pasco2_set_config(&mtb_pasco2_context, &pas_co2_config);
+        PASCO2_TRACE_SPAN_END(PASCO2_TRACE_SPAN_SET_CONFIG, CY_RSLT_GET_CODE(result));
         if (result == CY_RSLT_SUCCESS)
         {
-            /* New CO2 value is successfully read from sensor and print it to serial console */
-            if (display_ppm)
-            {
-                printf("CO2 PPM Level: %d\r\n", ppm);
-            }
-            /* Turn-off warning LED*/
-            cyhal_gpio_write(MTB_PASCO2_LED_WARNING, MTB_PASCO_LED_STATE_OFF);
+            applied_period = period;
+            sensor_message_post(SENSOR_MESSAGE_PERIOD, result, 0U, period);
+        }
+    }
+    if (applied_period == 0U)
+    {
+        /* No adaptive period has been set yet, the sensor still measures
+         * with the fixed period. The change is tried again with the next
+         * sample. */
+        return configured_period * 1000U;
+    }
+    return applied_period * 1000U;
+}
 
-            vTaskDelay(PASCO2_PROCESS_DELAY);
-            continue;
+/*******************************************************************************
+ * Function Name: sensor_fixed_period
+ *******************************************************************************
+ * Summary:
+ *   Restores the fixed measurement period once the adaptive mode has been
+ *   disabled. A failed attempt is repeated with the next sample.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   time until the next measurement in ms
+ *******************************************************************************/
+static uint32_t sensor_fixed_period(void)
+{
+    if (adaptive_active && (sensor_set_period(configured_period) == CY_RSLT_SUCCESS))
+    {
+        adaptive_active = false;
+        sensor_message_post(SENSOR_MESSAGE_PERIOD, CY_RSLT_SUCCESS, 0U, configured_period);
+    }
+    return PASCO2_PROCESS_DELAY;
+}
+
+/*******************************************************************************
+ * Function Name: sensor_measure
+ *******************************************************************************
+ * Summary:
+ *   Reads the CO2 value from the sensor and passes the result to the LED and
+ *   log jobs.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   time until the next measurement in ms
+ *******************************************************************************/
+static uint32_t sensor_measure(void)
+{
+    uint16_t ppm = 0;
+
+    /* Read CO2 value from sensor */
+    PASCO2_TRACE_SPAN_BEGIN(PASCO2_TRACE_SPAN_GET_PPM);
+    cy_rslt_t result = mtb_pasco2_get_ppm(&mtb_pasco2_context, &ppm);
+    PASCO2_TRACE_SPAN_END(PASCO2_TRACE_SPAN_GET_PPM, CY_RSLT_GET_CODE(result));
+
+    sensor_message_post(SENSOR_MESSAGE_SAMPLE, result, ppm, 0U);
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        /* Turn-off warning LED*/
+        pasco2_executor_signal(&led_job, LED_EVENT_WARNING_OFF);
+        if (!adaptive_period)
+        {
+            return sensor_fixed_period();
         }
-        else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_INFO)
+        return sensor_adapt_period(ppm);
+    }
+    else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_INFO)
+    {
+        if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_SENSOR_BUSY)
         {
-            /* Sensor gave other information than CO2 value */
-            if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_PPM_PENDING)
-            {
-                /* New value is not available yet */
-                conditional_log("CO2 PPM value is not ready\r\n");
-            }
-            else if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_SENSOR_BUSY)
-            {
-                /* Sensor is busy in internal processing */
-                conditional_log("CO2 sensor is busy\r\n");
-            }
-            else
-            {
-                conditional_log("An unexpected occurred when accessing the CO2 sensor\r\n");
-            }
-            /* Turn-Off warning LED */
-            cyhal_gpio_write(MTB_PASCO2_LED_WARNING, MTB_PASCO_LED_STATE_OFF);
-            /* Sensor is polled in 1 second again */
-            vTaskDelay(1000);
+            /* Keep the transfers which led to the busy state */
+            PASCO2_I2C_RECORD_FREEZE(result);
         }
-        else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_WARNING)
+        /* Turn-Off warning LED */
+        pasco2_executor_signal(&led_job, LED_EVENT_WARNING_OFF);
+        /* Sensor is polled in 1 second again */
+        return PASCO2_POLL_DELAY;
+    }
+    else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_WARNING)
+    {
+        if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_COMMUNICATION_ERROR)
         {
-            /* Sensor gave a warning regarding over-voltage, temperature, or communication problem */
-            switch (CY_RSLT_GET_CODE(result))
+            /* Register values read earlier may be corrupted */
+            pasco2_regcache_invalidate();
+            PASCO2_I2C_RECORD_FREEZE(result);
+        }
+        /* Turn-On warning LED to indicate warning to user from sensor */
+        pasco2_executor_signal(&led_job, LED_EVENT_WARNING_ON);
+    }
+    /* Sensor is polled again after a back-off, so that a persistent warning
+     * does not keep the executor busy */
+    return PASCO2_POLL_DELAY;
+}
+
+/*******************************************************************************
+ * Function Name: sensor_job_run
+ *******************************************************************************
+ * Summary:
+ *   Powers up and initializes the sensor and then continuously acquires data
+ *   from the sensor. Each step ends by scheduling the next one. Requests of
+ *   the terminal UI are applied once the sensor is initialized, without
+ *   changing the time of the next measurement.
+ *
+ * Parameters:
+ *   job: sensor job
+ *   events: PASCO2_EXECUTOR_EVENT_START, PASCO2_EXECUTOR_EVENT_TIMER or
+ *           SENSOR_EVENT_PERIOD
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void sensor_job_run(pasco2_job_t *job, uint32_t events)
+{
+    if (job->state == SENSOR_STATE_MEASURE)
+    {
+        sensor_apply_request();
+    }
+    if ((events & (PASCO2_EXECUTOR_EVENT_START | PASCO2_EXECUTOR_EVENT_TIMER)) == 0U)
+    {
+        return;
+    }
+
+    switch ((sensor_state_t)job->state)
+    {
+        case SENSOR_STATE_POWER_UP:
+            sensor_power_up();
+            job->state = SENSOR_STATE_INIT;
+            pasco2_executor_schedule(job, PASCO2_POWER_UP_DELAY);
+            break;
+        case SENSOR_STATE_INIT:
+            sensor_init();
+            /* Indicate successful initialization of CO2 Wing Board */
+            pasco2_executor_signal(&led_job, LED_EVENT_READY);
+            job->state = SENSOR_STATE_MEASURE;
+            pasco2_executor_schedule(job, 0U);
+            break;
+        case SENSOR_STATE_MEASURE:
+            sensor_job_wait(job, sensor_measure());
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: led_job_run
+ *******************************************************************************
+ * Summary:
+ *   Initializes the LEDs and updates them on events of the sensor job.
+ *
+ * Parameters:
+ *   job: LED job
+ *   events: PASCO2_EXECUTOR_EVENT_START and LED_EVENT_* events
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void led_job_run(pasco2_job_t *job, uint32_t events)
+{
+    if ((events & PASCO2_EXECUTOR_EVENT_START) != 0U)
+    {
+        /* Initialize the User LED on CYSBSYSKIT-DEV-01 and turn it on to show initialization of PAS CO2 Wing Board */
+        if (MTB_PASCO2_LED_INIT != NC)
+        {
+            cy_rslt_t result = cyhal_gpio_init(
+                MTB_PASCO2_LED_INIT, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_LED_INIT_STATE_ON);
+            if (result != CY_RSLT_SUCCESS)
             {
-                case MTB_PASCO2_VOLTAGE_ERROR:
-                    /* Sensor detected over-voltage problem */
-                    conditional_log("CO2 Sensor Over-Voltage Error\r\n");
-                    break;
-                case MTB_PASCO2_TEMPERATURE_ERROR:
-                    /* Sensor detected temperature problem */
-                    conditional_log("CO2 Sensor Temperature Error\r\n");
-                    break;
-                case MTB_PASCO2_COMMUNICATION_ERROR:
-                    /* Sensor detected communication problem with MCU */
-                    conditional_log("CO2 Sensor Communication Error\r\n");
-                    break;
-                default:
-                    conditional_log("Unexpected error\r\n");
-                    break;
+                CY_ASSERT(0);
             }
-            /* Turn-On warning LED to indicate warning to user from sensor */
-            cyhal_gpio_write(MTB_PASCO2_LED_WARNING, MTB_PASCO_LED_STATE_ON);
         }
-        pasco2_terminal_mutex_release();
+        /* Initialize the LEDs on PAS CO2 Wing Board */
+        if (MTB_PASCO2_LED_OK != NC)
+        {
+            cyhal_gpio_init(MTB_PASCO2_LED_OK, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
+        }
+        if (MTB_PASCO2_LED_WARNING != NC)
+        {
+            cyhal_gpio_init(
+                MTB_PASCO2_LED_WARNING, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
+        }
+    }
+    if ((events & LED_EVENT_READY) != 0U)
+    {
+        /* Turn off User LED on CYSBSYSKIT-DEV-01 to indicate successful initialization of CO2 Wing Board */
+        if (MTB_PASCO2_LED_INIT != NC)
+        {
+            cyhal_gpio_write(MTB_PASCO2_LED_INIT, MTB_PASCO2_LED_INIT_STATE_OFF);
+        }
+        /* Turn on status LED on PAS CO2 Wing Board to indicate normal operation */
+        if (MTB_PASCO2_LED_OK != NC)
+        {
+            cyhal_gpio_write(MTB_PASCO2_LED_OK, MTB_PASCO_LED_STATE_ON);
+        }
+    }
+    if (MTB_PASCO2_LED_WARNING == NC)
+    {
+        return;
+    }
+    if ((events & LED_EVENT_WARNING_ON) != 0U)
+    {
+        cyhal_gpio_write(MTB_PASCO2_LED_WARNING, MTB_PASCO_LED_STATE_ON);
+    }
+    else if ((events & LED_EVENT_WARNING_OFF) != 0U)
+    {
+        cyhal_gpio_write(MTB_PASCO2_LED_WARNING, MTB_PASCO_LED_STATE_OFF);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: log_sample
+ *******************************************************************************
+ * Summary:
+ *   Adds the CO2 value to the history and prints it or the sensor state of
+ *   a sample.
+ *
+ * Parameters:
+ *   result: result of the sensor read
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void log_sample(cy_rslt_t result, uint16_t ppm)
+{
+    if (result == CY_RSLT_SUCCESS)
+    {
+        pasco2_rollup_add(ppm);
+        /* New CO2 value is successfully read from sensor and print it to serial console */
+        if (display_ppm)
+        {
+            pasco2_printf("CO2 PPM Level: %d\r\n", ppm);
+        }
     }
+    else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_INFO)
+    {
+        /* Sensor gave other information than CO2 value */
+        if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_PPM_PENDING)
+        {
+            /* New value is not available yet */
+            conditional_log("CO2 PPM value is not ready\r\n");
+        }
+        else if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_SENSOR_BUSY)
+        {
+            /* Sensor is busy in internal processing */
+            conditional_log("CO2 sensor is busy\r\n");
+        }
+        else
+        {
+            conditional_log("An unexpected occurred when accessing the CO2 sensor\r\n");
+        }
+    }
+    else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_WARNING)
+    {
+        /* Sensor gave a warning regarding over-voltage, temperature, or communication problem */
+        switch (CY_RSLT_GET_CODE(result))
+        {
+            case MTB_PASCO2_VOLTAGE_ERROR:
+                /* Sensor detected over-voltage problem */
+                conditional_log("CO2 Sensor Over-Voltage Error\r\n");
+                break;
+            case MTB_PASCO2_TEMPERATURE_ERROR:
+                /* Sensor detected temperature problem */
+                conditional_log("CO2 Sensor Temperature Error\r\n");
+                break;
+            case MTB_PASCO2_COMMUNICATION_ERROR:
+                /* Sensor detected communication problem with MCU */
+                conditional_log("CO2 Sensor Communication Error\r\n");
+                break;
+            default:
+                conditional_log("Unexpected error\r\n");
+                break;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: log_request
+ *******************************************************************************
+ * Summary:
+ *   Prints the outcome of a measurement period requested by the terminal UI.
+ *
+ * Parameters:
+ *   result: result of the sensor configuration
+ *   period: requested measurement period in s
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void log_request(cy_rslt_t result, uint16_t period)
+{
+    if (result == CY_RSLT_SUCCESS)
+    {
+        pasco2_printf("CO2 measurement period set to: %d\r\n\r\n", period);
+    }
+    else if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_CONFIGURATION_ERROR)
+    {
+        pasco2_printf("CO2 sensor measurement period configuration error, Valid range is [%u-%u]\r\n\r\n",
+                      PASCO2_SENSOR_PERIOD_MIN,
+                      PASCO2_SENSOR_PERIOD_MAX);
+    }
+    else
+    {
+        pasco2_printf("CO2 measurement period could not be set\r\n\r\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: log_job_run
+ *******************************************************************************
+ * Summary:
+ *   Prints the samples, period changes and request outcomes posted by the
+ *   sensor job and returns the messages to their pool.
+ *
+ * Parameters:
+ *   job: log job
+ *   events: LOG_EVENT_MESSAGE
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void log_job_run(pasco2_job_t *job, uint32_t events)
+{
+    sensor_message_t *message;
+    while ((message = sensor_message_take()) != NULL)
+    {
+        if (message->type == SENSOR_MESSAGE_SAMPLE)
+        {
+            log_sample(message->result, message->ppm);
+        }
+        else if (message->type == SENSOR_MESSAGE_REQUEST)
+        {
+            log_request(message->result, message->period);
+        }
+        else if (message->type == SENSOR_MESSAGE_ADAPTIVE_OFF)
+        {
+            /* Only sent if the request ended the adaptive mode */
+            pasco2_printf("Disable adaptive measurement period\r\n\r\n");
+        }
+        else
+        {
+            conditional_log("CO2 measurement period changed to: %d\r\n", message->period);
+        }
+        pasco2_pool_free(&sensor_message_pool, message);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_task_init
+ *******************************************************************************
+ * Summary:
+ *   Adds the LED, sensor and log jobs to the executor. They initialize the
+ *   PAS CO2 Wing Board and sensor and continuously acquire data from the
+ *   sensor once the executor runs.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_task_init(void)
+{
+    pasco2_pool_init(&sensor_message_pool);
+    pasco2_executor_add(&led_job);
+    pasco2_executor_add(&sensor_job);
+    pasco2_executor_add(&log_job);
 }
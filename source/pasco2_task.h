@@ -38,14 +38,13 @@
  * Macros
  ******************************************************************************/
 
-/* Name of the pas co2 task */
-#define PASCO2_TASK_NAME "CO2 SENSOR TASK"
-/* Stack size for the co2 sensor task */
-#define PASCO2_TASK_STACK_SIZE (1024 * 4)
-/**< Priority number for the co2 sensor task */
-#define PASCO2_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
 /* Delay time after each call to Ifx_RadarSensing_Process */
 #define PASCO2_PROCESS_DELAY (10000)
+/* Time in ms until the sensor is polled again if no value is available or
+ * after a warning */
+#define PASCO2_POLL_DELAY (1000U)
+/* Measurement period of the sensor in s after reset */
+#define PASCO2_MEASUREMENT_PERIOD_DEFAULT (10U)
 /*******************************************************************************
  * Global Variables
  *******************************************************************************/
@@ -55,8 +54,8 @@ extern mtb_pasco2_context_t mtb_pasco2_context;
  * Functions
  *******************************************************************************/
 
-void pasco2_task(cy_thread_arg_t arg);
+void pasco2_task_init(void);
 void pasco2_enable_internal_logging(bool enable_logging);
 void pasco2_display_ppm(bool enable_output);
-cy_rslt_t pasco2_terminal_mutex_get(cy_time_t timeout_ms);
-cy_rslt_t pasco2_terminal_mutex_release(void);
+void pasco2_enable_adaptive_period(bool enable_adaptive);
+void pasco2_request_measurement_period(uint16_t period);
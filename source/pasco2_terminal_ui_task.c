@@ -26,6 +26,7 @@
 /* Header file from system */
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Header file includes */
 #include "cy_retarget_io.h"
@@ -33,14 +34,49 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "pasco2_board.h"
+#include "pasco2_config_store.h"
+#include "pasco2_executor.h"
+#include "pasco2_health.h"
+#include "pasco2_i2c_record.h"
+#include "pasco2_pool.h"
+#include "pasco2_print.h"
+#include "pasco2_regcache.h"
+#include "pasco2_rollup.h"
 #include "pasco2_task.h"
 #include "pasco2_terminal_ui_task.h"
+#include "pasco2_trace.h"
 
 /*******************************************************************************
  * Constants
  *******************************************************************************/
 #define IFX_PASCO2_VALUE_MAXLENGTH 256
 
+/* Characters were received */
+#define TERMINAL_UI_EVENT_RX (PASCO2_EXECUTOR_EVENT_USER << 0)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Resume points of the terminal UI job */
+typedef enum
+{
+    TERMINAL_UI_STATE_COMMAND,  /* waiting for a key */
+    TERMINAL_UI_STATE_READLINE, /* reading the value of a command */
+} terminal_ui_state_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static void terminal_ui_job_run(pasco2_job_t *job, uint32_t events);
+
+static pasco2_job_t terminal_ui_job = {.name = "terminal UI", .handler = terminal_ui_job_run};
+
+/* Value being read and the command which receives it */
+static char terminal_ui_line[IFX_PASCO2_VALUE_MAXLENGTH];
+static int terminal_ui_length = 0;
+static char terminal_ui_pending = 0;
+
 /*******************************************************************************
  * Function Name: terminal_ui_menu
  ********************************************************************************
@@ -56,14 +92,24 @@
 static void terminal_ui_menu(void)
 {
     // Print main menu
-    pasco2_terminal_mutex_get(0);
     pasco2_display_ppm(false);
-    printf("Select a setting to configure\r\n");
-    printf("'p': Set the measurement period\r\n");
-    printf("'i': Print additional diagnostic information if available\r\n");
-    printf("\r\n");
+    pasco2_printf("Select a setting to configure\r\n");
+    pasco2_printf("'p': Set the measurement period\r\n");
+    pasco2_printf("'i': Print additional diagnostic information if available\r\n");
+    pasco2_printf("'a': Adapt the measurement period to the CO2 rate of change\r\n");
+    pasco2_printf("'e': Print executor job statistics\r\n");
+    pasco2_printf("'m': Print memory pool statistics\r\n");
+    pasco2_printf("'h': Print task health statistics\r\n");
+    pasco2_printf("'r': Print register cache statistics\r\n");
+    pasco2_printf("'q': Query min, max and mean CO2 of a time range\r\n");
+#if defined(PASCO2_TRACE_ENABLED)
+    pasco2_printf("'t': Dump the kernel event trace\r\n");
+#endif
+#if defined(PASCO2_I2C_RECORD_ENABLED)
+    pasco2_printf("'l': Dump the I2C transfer recording\r\n");
+#endif
+    pasco2_printf("\r\n");
     pasco2_display_ppm(true);
-    pasco2_terminal_mutex_release();
 }
 
 /*******************************************************************************
@@ -81,115 +127,293 @@ static void terminal_ui_menu(void)
  *******************************************************************************/
 static void terminal_ui_info(void)
 {
-    printf("Press '?' to list all CO2 sensor settings\r\n");
+    pasco2_printf("Press '?' to list all CO2 sensor settings\r\n");
 }
 
 /*******************************************************************************
- * Function Name: terminal_ui_readline
+ * Function Name: terminal_ui_uart_callback
  ********************************************************************************
  * Summary:
- *   This function reads values entered by a user and prints it.
+ *   UART interrupt callback. Masks the receive interrupt until the terminal UI
+ *   job has read the received characters.
  *
  * Parameters:
- *   uart_ptr: UART object
- *   line: value to be read
- *   maxlength: maximum number of characters to be read
+ *   callback_arg: not used
+ *   event: UART event
  *
  * Return:
  *   none
  *******************************************************************************/
-static void terminal_ui_readline(void *uart_ptr, char *line, int maxlength)
+static void terminal_ui_uart_callback(void *callback_arg, cyhal_uart_event_t event)
 {
-    pasco2_display_ppm(false);
-    if (maxlength <= 0)
+    PASCO2_TRACE_ISR_ENTER();
+    if ((event & CYHAL_UART_IRQ_RX_NOT_EMPTY) != 0)
     {
-        return;
+        cyhal_uart_enable_event(
+            &cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, CYHAL_ISR_PRIORITY_DEFAULT, false);
+        pasco2_executor_signal_from_isr(&terminal_ui_job, TERMINAL_UI_EVENT_RX);
     }
-    int i = 0;
-    uint8_t rx_value = 0;
-    /* Receive character until enter has been pressed */
-    while ((rx_value != '\r') && (--maxlength > 0))
+    PASCO2_TRACE_ISR_EXIT();
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_readline
+ ********************************************************************************
+ * Summary:
+ *   This function starts reading a value entered by a user for a command.
+ *
+ * Parameters:
+ *   command: command which receives the value
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_readline(char command)
+{
+    pasco2_display_ppm(false);
+    terminal_ui_pending = command;
+    terminal_ui_length = 0;
+    terminal_ui_job.state = TERMINAL_UI_STATE_READLINE;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_readline_putc
+ ********************************************************************************
+ * Summary:
+ *   This function adds a character to the value being read and prints it.
+ *
+ * Parameters:
+ *   uart_ptr: UART object
+ *   rx_value: received character
+ *
+ * Return:
+ *   true if enter has been pressed or the maximum length is reached
+ *******************************************************************************/
+static bool terminal_ui_readline_putc(void *uart_ptr, uint8_t rx_value)
+{
+    cyhal_uart_putc(uart_ptr, rx_value);
+    if ((rx_value != '\r') && (terminal_ui_length < (IFX_PASCO2_VALUE_MAXLENGTH - 2)))
     {
-        cyhal_uart_getc(uart_ptr, &rx_value, 0);
-        cyhal_uart_putc(uart_ptr, rx_value);
-        if (isspace(rx_value))
+        if (!isspace(rx_value))
         {
-            continue;
+            terminal_ui_line[terminal_ui_length++] = rx_value;
         }
-        line[i++] = rx_value;
+        return false;
     }
     cyhal_uart_putc(uart_ptr, '\n');
-    line[i] = '\0';
+    terminal_ui_line[terminal_ui_length] = '\0';
     pasco2_display_ppm(true);
+    return true;
 }
 
 /*******************************************************************************
- * Function Name: radar_presence_terminal_ui
+ * Function Name: terminal_ui_value
  ********************************************************************************
  * Summary:
- *   Continuously checks if a key has been pressed to configure CO2 sensor
- *   parameter. Displays a status message according to the user
- *   input/selection.
+ *   Applies the value entered by a user for a command.
  *
  * Parameters:
- *   arg: thread
+ *   command: command which requested the value
+ *   value: entered value
  *
  * Return:
  *   none
  *******************************************************************************/
-void pasco2_terminal_ui_task(cy_thread_arg_t arg)
+static void terminal_ui_value(char command, const char *value)
 {
-    terminal_ui_menu();
-    char value[IFX_PASCO2_VALUE_MAXLENGTH];
-    uint8_t rx_value = 0;
-
-    /* Check if a key was pressed */
-    while (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) == CY_RSLT_SUCCESS)
+    switch (command)
     {
-        pasco2_terminal_mutex_get(0);
-        switch ((char)rx_value)
+        // measurement period
+        case 'p':
         {
-            // menu
-            case '?':
-                terminal_ui_menu();
+            int period = atoi(value);
+            if ((period < (int)PASCO2_SENSOR_PERIOD_MIN) || (period > (int)PASCO2_SENSOR_PERIOD_MAX))
+            {
+                pasco2_printf("CO2 sensor measurement period configuration error, Valid range is [%u-%u]\r\n\r\n",
+                              PASCO2_SENSOR_PERIOD_MIN,
+                              PASCO2_SENSOR_PERIOD_MAX);
                 break;
-            // measurement period
-            case 'p':
+            }
+            /* The sensor job writes the period and prints the outcome, the
+             * UI does not wait for the I2C transfers */
+            pasco2_request_measurement_period((uint16_t)period);
+        }
+        break;
+        case 'i':
+            if (strlen(value) != 1 || (value[0] != 'y' && value[0] != 'n'))
             {
-                printf("Enter the measurement period [10-4095]s\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_PASCO2_VALUE_MAXLENGTH);
-                mtb_pasco2_config_t pas_co2_config = {
-                    .measurement_period = atoi(value),
-                };
-                cy_rslt_t result = mtb_pasco2_set_config(&mtb_pasco2_context, &pas_co2_config);
-                if (result == CY_RSLT_SUCCESS)
-                {
-                    printf("CO2 measurement period set to: %d\r\n\r\n", pas_co2_config.measurement_period);
-                    continue;
-                }
-                if (CY_RSLT_GET_CODE(result) == MTB_PASCO2_CONFIGURATION_ERROR)
-                {
-                    printf("CO2 sensor measurement period configuration error, Valid range is [10-4095]\r\n\r\n");
-                }
+                pasco2_printf("Input error, valid values are [y/n]\r\n\r\n");
+                break;
             }
+            pasco2_enable_internal_logging(value[0] == 'y');
             break;
-            case 'i':
-                printf("Display additional diagnostic information [y/n]?\r\n");
-                terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_PASCO2_VALUE_MAXLENGTH);
-                if (strlen(value) != 1 || (value[0] != 'y' && value[0] != 'n'))
-                {
-                    printf("Input error, valid values are [y/n]\r\n\r\n");
-                    continue;
-                }
-                pasco2_enable_internal_logging(value[0] == 'y');
+        case 'a':
+            if (strlen(value) != 1 || (value[0] != 'y' && value[0] != 'n'))
+            {
+                pasco2_printf("Input error, valid values are [y/n]\r\n\r\n");
+                break;
+            }
+            pasco2_enable_adaptive_period(value[0] == 'y');
+            pasco2_config_store_set_adaptive_period(value[0] == 'y');
+            break;
+        // history query, a number of minutes, hours or days
+        case 'q':
+        {
+            char *unit;
+            unsigned long range = strtoul(value, &unit, 10);
+            uint32_t scale = (strcmp(unit, "m") == 0) ? 60U
+                             : (strcmp(unit, "h") == 0) ? 3600U
+                             : (strcmp(unit, "d") == 0) ? 86400U
+                                                        : 0U;
+            if ((unit == value) || (scale == 0U) || (range == 0U) || (range > (UINT32_MAX / scale)))
+            {
+                pasco2_printf("Input error, valid values are e.g. 30m, 24h or 7d\r\n\r\n");
                 break;
-            default:
-                terminal_ui_info();
+            }
+            pasco2_display_ppm(false);
+            pasco2_rollup_print_query((uint32_t)range * scale);
+            pasco2_display_ppm(true);
         }
-        pasco2_terminal_mutex_release();
-        rx_value = 0;
+        break;
+        default:
+            break;
     }
-    printf("Exiting terminal ui\r\n");
-    // exit current thread (suspend)
-    (void)cy_rtos_exit_thread();
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_command
+ ********************************************************************************
+ * Summary:
+ *   Executes the command of a pressed key or asks for its value.
+ *
+ * Parameters:
+ *   command: pressed key
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_command(char command)
+{
+    switch (command)
+    {
+        // menu
+        case '?':
+            terminal_ui_menu();
+            break;
+        // measurement period
+        case 'p':
+            pasco2_printf(
+                "Enter the measurement period [%u-%u]s\r\n", PASCO2_SENSOR_PERIOD_MIN, PASCO2_SENSOR_PERIOD_MAX);
+            terminal_ui_readline(command);
+            break;
+        case 'i':
+            pasco2_printf("Display additional diagnostic information [y/n]?\r\n");
+            terminal_ui_readline(command);
+            break;
+        case 'a':
+            pasco2_printf("Adapt measurement period to CO2 rate of change [y/n]?\r\n");
+            terminal_ui_readline(command);
+            break;
+        case 'q':
+            pasco2_printf("Enter the query range in minutes, hours or days, e.g. 30m, 24h or 7d\r\n");
+            terminal_ui_readline(command);
+            break;
+        case 'e':
+            pasco2_display_ppm(false);
+            pasco2_executor_print_statistics();
+            pasco2_display_ppm(true);
+            break;
+        case 'h':
+            pasco2_display_ppm(false);
+            pasco2_health_print_statistics();
+            pasco2_display_ppm(true);
+            break;
+        case 'm':
+            pasco2_display_ppm(false);
+            pasco2_pool_print_statistics();
+            pasco2_display_ppm(true);
+            break;
+        case 'r':
+            pasco2_display_ppm(false);
+            pasco2_regcache_print_statistics();
+            pasco2_display_ppm(true);
+            break;
+#if defined(PASCO2_TRACE_ENABLED)
+        case 't':
+            pasco2_display_ppm(false);
+            pasco2_trace_dump();
+            pasco2_display_ppm(true);
+            break;
+#endif
+#if defined(PASCO2_I2C_RECORD_ENABLED)
+        case 'l':
+            pasco2_display_ppm(false);
+            pasco2_i2c_record_dump();
+            pasco2_display_ppm(true);
+            break;
+#endif
+        default:
+            terminal_ui_info();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_job_run
+ ********************************************************************************
+ * Summary:
+ *   Processes the characters received since the last run. A key selects a
+ *   CO2 sensor parameter to configure, the following characters up to enter
+ *   are read as its value. Displays a status message according to the user
+ *   input/selection.
+ *
+ * Parameters:
+ *   job: terminal UI job
+ *   events: PASCO2_EXECUTOR_EVENT_START or TERMINAL_UI_EVENT_RX
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+static void terminal_ui_job_run(pasco2_job_t *job, uint32_t events)
+{
+    if ((events & PASCO2_EXECUTOR_EVENT_START) != 0U)
+    {
+        terminal_ui_menu();
+        cyhal_uart_register_callback(&cy_retarget_io_uart_obj, terminal_ui_uart_callback, NULL);
+    }
+
+    uint8_t rx_value = 0;
+    while ((cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0U) &&
+           (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) == CY_RSLT_SUCCESS))
+    {
+        if (job->state == TERMINAL_UI_STATE_COMMAND)
+        {
+            terminal_ui_command((char)rx_value);
+        }
+        else if (terminal_ui_readline_putc(&cy_retarget_io_uart_obj, rx_value))
+        {
+            job->state = TERMINAL_UI_STATE_COMMAND;
+            terminal_ui_value(terminal_ui_pending, terminal_ui_line);
+        }
+    }
+
+    /* Wait for the next character */
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_terminal_ui_init
+ ********************************************************************************
+ * Summary:
+ *   Adds the terminal UI job to the executor. It continuously checks if a key
+ *   has been pressed to configure CO2 sensor parameter.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_terminal_ui_init(void)
+{
+    pasco2_executor_add(&terminal_ui_job);
 }
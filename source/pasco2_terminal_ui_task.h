@@ -27,17 +27,7 @@
 /* Header file for local task */
 #include "pasco2_task.h"
 
-/*******************************************************************************
- * Macros
- *******************************************************************************/
-/* Name of the pasco2 terminal ui task */
-#define PASCO2_TERMINAL_UI_TASK_NAME "PASCO2 TERMINAL UI"
-/* Stack size for pasco2 presence terminal ui */
-#define PASCO2_TERMINAL_UI_TASK_STACK_SIZE (2048)
-/* Priority number for pasco2 terminal ui */
-#define PASCO2_TERMINAL_UI_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
-
 /*******************************************************************************
  * Functions
  *******************************************************************************/
-void pasco2_terminal_ui_task(cy_thread_arg_t arg);
+void pasco2_terminal_ui_init(void);
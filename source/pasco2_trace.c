@@ -0,0 +1,199 @@
+/*****************************************************************************
+** File name: pasco2_trace.c
+**
+** Description: This file implements a low-overhead kernel event tracer which
+** records FreeRTOS trace hooks and sensor driver spans into a binary ring.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_print.h"
+#include "pasco2_trace.h"
+
+#if defined(PASCO2_TRACE_ENABLED)
+
+/* Number of bytes printed per line by pasco2_trace_dump */
+#define PASCO2_TRACE_DUMP_LINE_LENGTH (32U)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+
+/* Trace buffer, can also be saved with the debugger by its symbol name */
+pasco2_trace_buffer_t pasco2_trace_buffer;
+
+static volatile bool trace_enabled = false;
+
+/*******************************************************************************
+ * Function Name: pasco2_trace_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the trace buffer header, starts the DWT cycle counter used as
+ *   timestamp and enables recording. Has to be called before the application
+ *   tasks are created so that their names are captured.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_trace_init(void)
+{
+    pasco2_trace_buffer.magic = PASCO2_TRACE_MAGIC;
+    pasco2_trace_buffer.version = PASCO2_TRACE_VERSION;
+    pasco2_trace_buffer.record_size = sizeof(pasco2_trace_record_t);
+    pasco2_trace_buffer.capacity = PASCO2_TRACE_BUFFER_EVENTS;
+    pasco2_trace_buffer.head = 0;
+    pasco2_trace_buffer.timestamp_hz = SystemCoreClock;
+
+    /* Enable the cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    trace_enabled = true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_trace_enable
+ *******************************************************************************
+ * Summary:
+ *   Pauses or resumes recording, e.g. to take a consistent snapshot.
+ *
+ * Parameters:
+ *   enable: recording state
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_trace_enable(bool enable)
+{
+    trace_enabled = enable;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_trace_record
+ *******************************************************************************
+ * Summary:
+ *   Appends an event to the ring. The oldest event is overwritten when the
+ *   ring is full. Safe to be called from tasks, the scheduler and ISRs.
+ *
+ * Parameters:
+ *   event: pasco2_trace_event_t
+ *   arg: event argument
+ *   aux: auxiliary event data
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_trace_record(uint16_t event, uint32_t arg, uint16_t aux)
+{
+    if (!trace_enabled)
+    {
+        return;
+    }
+
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    pasco2_trace_record_t *record =
+        &pasco2_trace_buffer.records[pasco2_trace_buffer.head & (PASCO2_TRACE_BUFFER_EVENTS - 1U)];
+    record->timestamp = DWT->CYCCNT;
+    record->arg = arg;
+    record->event = event;
+    record->aux = aux;
+    pasco2_trace_buffer.head++;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_trace_name_object
+ *******************************************************************************
+ * Summary:
+ *   Adds a name for a task or mutex to the name table of the trace buffer.
+ *   An existing entry with the same type and id is replaced. Names are
+ *   dropped silently when the table is full.
+ *
+ * Parameters:
+ *   type: pasco2_trace_object_t
+ *   id: task number or mutex handle
+ *   name: object name, truncated to PASCO2_TRACE_NAME_LENGTH - 1 characters
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_trace_name_object(uint8_t type, uint32_t id, const char *name)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    for (uint32_t i = 0; i < PASCO2_TRACE_NAME_ENTRIES; i++)
+    {
+        pasco2_trace_name_t *entry = &pasco2_trace_buffer.names[i];
+        if ((entry->type == 0U) || ((entry->type == type) && (entry->id == id)))
+        {
+            entry->type = type;
+            entry->id = id;
+            strncpy(entry->name, name, PASCO2_TRACE_NAME_LENGTH - 1U);
+            entry->name[PASCO2_TRACE_NAME_LENGTH - 1U] = '\0';
+            break;
+        }
+    }
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_trace_dump
+ *******************************************************************************
+ * Summary:
+ *   Prints the complete trace buffer as hex lines framed by begin and end
+ *   markers. Recording is paused during the dump. The output is converted by
+ *   scripts/pasco2_trace_convert.py.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ *******************************************************************************/
+void pasco2_trace_dump(void)
+{
+    bool was_enabled = trace_enabled;
+    trace_enabled = false;
+
+    const uint8_t *data = (const uint8_t *)&pasco2_trace_buffer;
+    pasco2_printf("PASCO2-TRACE-BEGIN\r\n");
+    for (uint32_t i = 0; i < sizeof(pasco2_trace_buffer); i++)
+    {
+        pasco2_printf("%02x", data[i]);
+        if (((i + 1U) % PASCO2_TRACE_DUMP_LINE_LENGTH) == 0U)
+        {
+            pasco2_printf("\r\n");
+        }
+    }
+    pasco2_printf("\r\nPASCO2-TRACE-END\r\n\r\n");
+
+    trace_enabled = was_enabled;
+}
+
+#endif /* defined(PASCO2_TRACE_ENABLED) */
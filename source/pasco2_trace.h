@@ -0,0 +1,200 @@
+/******************************************************************************
+** File name: pasco2_trace.h
+**
+** Description: This file contains the function prototypes, constants and
+**   FreeRTOS trace hook macros used in pasco2_trace.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* This header is included from FreeRTOSConfig.h, it must not include any
+ * FreeRTOS header itself. */
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Number of events in the trace ring, must be a power of two */
+#define PASCO2_TRACE_BUFFER_EVENTS (1024U)
+/* Number of entries in the object name table */
+#define PASCO2_TRACE_NAME_ENTRIES (16U)
+/* Maximum length of an object name including termination */
+#define PASCO2_TRACE_NAME_LENGTH (16U)
+/* Magic value at the start of the trace buffer ("PCTR") */
+#define PASCO2_TRACE_MAGIC (0x52544350UL)
+/* Version of the binary trace layout */
+#define PASCO2_TRACE_VERSION (1U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Event identifiers, the values are part of the binary trace layout */
+typedef enum
+{
+    PASCO2_TRACE_EVT_TASK_SWITCHED_IN = 1,  /* arg: task number */
+    PASCO2_TRACE_EVT_TASK_SWITCHED_OUT = 2, /* arg: task number */
+    PASCO2_TRACE_EVT_MUTEX_TAKE = 3,        /* arg: mutex handle */
+    PASCO2_TRACE_EVT_MUTEX_TAKE_FAILED = 4, /* arg: mutex handle */
+    PASCO2_TRACE_EVT_MUTEX_BLOCK = 5,       /* arg: mutex handle */
+    PASCO2_TRACE_EVT_MUTEX_GIVE = 6,        /* arg: mutex handle */
+    PASCO2_TRACE_EVT_PRIORITY_INHERIT = 7,  /* arg: task number, aux: new priority */
+    PASCO2_TRACE_EVT_PRIORITY_RESTORE = 8,  /* arg: task number, aux: new priority */
+    PASCO2_TRACE_EVT_NOTIFY = 9,            /* arg: notified task number */
+    PASCO2_TRACE_EVT_NOTIFY_FROM_ISR = 10,  /* arg: notified task number */
+    PASCO2_TRACE_EVT_NOTIFY_WAIT = 11,      /* arg: waiting task number */
+    PASCO2_TRACE_EVT_ISR_ENTER = 12,        /* arg: interrupt number */
+    PASCO2_TRACE_EVT_ISR_EXIT = 13,         /* arg: interrupt number */
+    PASCO2_TRACE_EVT_SPAN_BEGIN = 14,       /* arg: pasco2_trace_span_t */
+    PASCO2_TRACE_EVT_SPAN_END = 15,         /* arg: pasco2_trace_span_t, aux: result code */
+} pasco2_trace_event_t;
+
+/* Custom spans around sensor driver calls */
+typedef enum
+{
+    PASCO2_TRACE_SPAN_SENSOR_INIT = 1,
+    PASCO2_TRACE_SPAN_GET_PPM = 2,
+    PASCO2_TRACE_SPAN_SET_CONFIG = 3,
+} pasco2_trace_span_t;
+
+/* Object types of the name table */
+typedef enum
+{
+    PASCO2_TRACE_OBJECT_TASK = 1,
+    PASCO2_TRACE_OBJECT_MUTEX = 2,
+} pasco2_trace_object_t;
+
+typedef struct
+{
+    uint32_t timestamp; /* DWT cycle counter */
+    uint32_t arg;
+    uint16_t event; /* pasco2_trace_event_t */
+    uint16_t aux;
+} pasco2_trace_record_t;
+
+typedef struct
+{
+    uint8_t type; /* pasco2_trace_object_t */
+    uint8_t reserved[3];
+    uint32_t id;
+    char name[PASCO2_TRACE_NAME_LENGTH];
+} pasco2_trace_name_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t head; /* total number of recorded events */
+    uint32_t timestamp_hz;
+    pasco2_trace_name_t names[PASCO2_TRACE_NAME_ENTRIES];
+    pasco2_trace_record_t records[PASCO2_TRACE_BUFFER_EVENTS];
+} pasco2_trace_buffer_t;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void pasco2_trace_init(void);
+void pasco2_trace_enable(bool enable);
+void pasco2_trace_record(uint16_t event, uint32_t arg, uint16_t aux);
+void pasco2_trace_name_object(uint8_t type, uint32_t id, const char *name);
+void pasco2_trace_dump(void);
+
+/*******************************************************************************
+ * Instrumentation macros
+ *******************************************************************************/
+#if defined(PASCO2_TRACE_ENABLED)
+
+#define PASCO2_TRACE_SPAN_BEGIN(span) pasco2_trace_record(PASCO2_TRACE_EVT_SPAN_BEGIN, (span), 0U)
+#define PASCO2_TRACE_SPAN_END(span, result)                                                                            \
+    pasco2_trace_record(PASCO2_TRACE_EVT_SPAN_END, (span), (uint16_t)(result))
+/* To be placed at the start and end of application interrupt handlers and
+ * HAL interrupt callbacks. The interrupt number is read from IPSR. */
+#define PASCO2_TRACE_ISR_ENTER() pasco2_trace_record(PASCO2_TRACE_EVT_ISR_ENTER, __get_IPSR() - 16U, 0U)
+#define PASCO2_TRACE_ISR_EXIT()  pasco2_trace_record(PASCO2_TRACE_EVT_ISR_EXIT, __get_IPSR() - 16U, 0U)
+
+/* FreeRTOS trace hooks. They expand inside tasks.c and queue.c and therefore
+ * may access the private TCB and queue members. */
+#define pasco2_trace_is_mutex(q)                                                                                       \
+    (((q)->ucQueueType == queueQUEUE_TYPE_MUTEX) || ((q)->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX))
+
+#define traceTASK_CREATE(pxNewTCB)                                                                                     \
+    pasco2_trace_name_object(PASCO2_TRACE_OBJECT_TASK, (pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName)
+#define traceTASK_SWITCHED_IN()                                                                                        \
+    pasco2_trace_record(PASCO2_TRACE_EVT_TASK_SWITCHED_IN, pxCurrentTCB->uxTCBNumber, pxCurrentTCB->uxPriority)
+#define traceTASK_SWITCHED_OUT()                                                                                       \
+    pasco2_trace_record(PASCO2_TRACE_EVT_TASK_SWITCHED_OUT, pxCurrentTCB->uxTCBNumber, pxCurrentTCB->uxPriority)
+#define traceTASK_PRIORITY_INHERIT(pxTCB, uxPriority)                                                                  \
+    pasco2_trace_record(PASCO2_TRACE_EVT_PRIORITY_INHERIT, (pxTCB)->uxTCBNumber, (uint16_t)(uxPriority))
+#define traceTASK_PRIORITY_DISINHERIT(pxTCB, uxPriority)                                                               \
+    pasco2_trace_record(PASCO2_TRACE_EVT_PRIORITY_RESTORE, (pxTCB)->uxTCBNumber, (uint16_t)(uxPriority))
+#define traceTASK_NOTIFY() pasco2_trace_record(PASCO2_TRACE_EVT_NOTIFY, pxTCB->uxTCBNumber, 0U)
+#define traceTASK_NOTIFY_FROM_ISR()                                                                                    \
+    pasco2_trace_record(PASCO2_TRACE_EVT_NOTIFY_FROM_ISR, pxTCB->uxTCBNumber, 0U)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR()                                                                               \
+    pasco2_trace_record(PASCO2_TRACE_EVT_NOTIFY_FROM_ISR, pxTCB->uxTCBNumber, 0U)
+#define traceTASK_NOTIFY_TAKE_BLOCK()                                                                                  \
+    pasco2_trace_record(PASCO2_TRACE_EVT_NOTIFY_WAIT, pxCurrentTCB->uxTCBNumber, 0U)
+#define traceTASK_NOTIFY_WAIT_BLOCK()                                                                                  \
+    pasco2_trace_record(PASCO2_TRACE_EVT_NOTIFY_WAIT, pxCurrentTCB->uxTCBNumber, 0U)
+#define traceQUEUE_RECEIVE(pxQueue)                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (pasco2_trace_is_mutex(pxQueue))                                                                            \
+        {                                                                                                              \
+            pasco2_trace_record(PASCO2_TRACE_EVT_MUTEX_TAKE, (uint32_t)(uintptr_t)(pxQueue), 0U);                      \
+        }                                                                                                              \
+    } while (0)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)                                                                             \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (pasco2_trace_is_mutex(pxQueue))                                                                            \
+        {                                                                                                              \
+            pasco2_trace_record(PASCO2_TRACE_EVT_MUTEX_TAKE_FAILED, (uint32_t)(uintptr_t)(pxQueue), 0U);               \
+        }                                                                                                              \
+    } while (0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (pasco2_trace_is_mutex(pxQueue))                                                                            \
+        {                                                                                                              \
+            pasco2_trace_record(PASCO2_TRACE_EVT_MUTEX_BLOCK, (uint32_t)(uintptr_t)(pxQueue), 0U);                     \
+        }                                                                                                              \
+    } while (0)
+#define traceQUEUE_SEND(pxQueue)                                                                                       \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (pasco2_trace_is_mutex(pxQueue))                                                                            \
+        {                                                                                                              \
+            pasco2_trace_record(PASCO2_TRACE_EVT_MUTEX_GIVE, (uint32_t)(uintptr_t)(pxQueue), 0U);                      \
+        }                                                                                                              \
+    } while (0)
+
+#else
+
+#define PASCO2_TRACE_SPAN_BEGIN(span)
+#define PASCO2_TRACE_SPAN_END(span, result)
+#define PASCO2_TRACE_ISR_ENTER()
+#define PASCO2_TRACE_ISR_EXIT()
+
+#endif /* defined(PASCO2_TRACE_ENABLED) */
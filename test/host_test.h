@@ -0,0 +1,70 @@
+/******************************************************************************
+** File name: host_test.h
+**
+** Description: This file contains the check macro and the simulated time
+**   shared by the host tests.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Macros
+ *******************************************************************************/
+/* Stops the test with a message if the condition does not hold */
+#define HOST_CHECK(condition)                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                              \
+            exit(EXIT_FAILURE);                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Simulated time in ms returned by cy_rtos_get_time */
+extern uint32_t host_time_ms;
+
+/* Reset reason returned by cyhal_system_get_reset_reason */
+extern uint32_t host_reset_reason;
+
+/* Backing file of the Emulated EEPROM, successful writes and number of
+ * writes which shall fail */
+extern const char *host_eeprom_path;
+extern uint32_t host_eeprom_writes;
+extern uint32_t host_eeprom_fail_writes;
+
+/* Characters written to the debug UART, terminated by '\0' */
+extern char host_uart_output[];
+extern size_t host_uart_length;
+
+/*******************************************************************************
+ * Functions
+ *******************************************************************************/
+void host_uart_clear(void);
+bool host_wdt_expired(void);
@@ -0,0 +1,13 @@
+/* Host stand-in for the FreeRTOS types used by the modules under test */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void *TaskHandle_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE  (1)
+#define pdFALSE (0)
@@ -0,0 +1,44 @@
+/* Host stand-in for the Emulated EEPROM middleware. The EEPROM content is
+ * kept in the file host_eeprom_path, see em_eeprom_file.c. */
+#pragma once
+
+#include "cy_result.h"
+
+#define CY_EM_EEPROM_FLASH_SIZEOF_ROW (512U)
+#define CY_EM_EEPROM_GET_PHYSICAL_SIZE(size, simple_mode, wear_leveling, redundant_copy)                               \
+    ((((size) + CY_EM_EEPROM_FLASH_SIZEOF_ROW - 1U) / CY_EM_EEPROM_FLASH_SIZEOF_ROW) * CY_EM_EEPROM_FLASH_SIZEOF_ROW * \
+     (wear_leveling) * ((redundant_copy) + 1U))
+
+typedef enum
+{
+    CY_EM_EEPROM_SUCCESS = 0,
+    CY_EM_EEPROM_BAD_PARAM = 1,
+    CY_EM_EEPROM_BAD_CHECKSUM = 2,
+    CY_EM_EEPROM_BAD_DATA = 3,
+    CY_EM_EEPROM_WRITE_FAIL = 4,
+} cy_en_em_eeprom_status_t;
+
+typedef struct
+{
+    uint32_t eepromSize;
+    uint32_t wearLevelingFactor;
+    uint8_t redundantCopy;
+    uint8_t blockingWrite;
+    uint8_t simpleMode;
+    uint32_t userFlashStartAddr;
+} cy_stc_eeprom_config_t;
+
+typedef struct
+{
+    uint32_t eepromSize;
+} cy_stc_eeprom_context_t;
+
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Init(const cy_stc_eeprom_config_t *config, cy_stc_eeprom_context_t *context);
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Read(uint32_t addr,
+                                           void *eepromData,
+                                           uint32_t size,
+                                           cy_stc_eeprom_context_t *context);
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Write(uint32_t addr,
+                                            const void *eepromData,
+                                            uint32_t size,
+                                            cy_stc_eeprom_context_t *context);
@@ -0,0 +1,37 @@
+/* Host stand-in for the subset of the peripheral driver library used by the
+ * modules under test. The modules which disable interrupts are tested single
+ * threaded, so the critical sections do nothing. */
+#pragma once
+
+#include "cy_result.h"
+
+/* Cycle counter of the data watchpoint unit, advanced by the tests */
+typedef struct
+{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT                        (&host_dwt)
+#define CoreDebug                  (&host_core_debug)
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+extern uint32_t SystemCoreClock;
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0U;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t saved_intr_status)
+{
+    (void)saved_intr_status;
+}
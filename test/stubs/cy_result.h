@@ -0,0 +1,40 @@
+/* Host stand-in for the result codes of the Cypress core library */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS ((cy_rslt_t)0U)
+
+#define CY_RSLT_TYPE_INFO    (0U)
+#define CY_RSLT_TYPE_WARNING (1U)
+#define CY_RSLT_TYPE_ERROR   (2U)
+#define CY_RSLT_TYPE_FATAL   (3U)
+
+#define CY_RSLT_GET_TYPE(x)   (((x) >> 16) & 0x3U)
+#define CY_RSLT_GET_MODULE(x) (((x) >> 18) & 0x3FFFU)
+#define CY_RSLT_GET_CODE(x)   ((x)&0xFFFFU)
+#define CY_RSLT_CREATE(type, module, code)                                                                             \
+    ((((module)&0x3FFFU) << 18) | (((type)&0x3U) << 16) | ((code)&0xFFFFU))
+
+#define CY_RSLT_MODULE_MIDDLEWARE_BASE (0x1A0U)
+#define CY_RSLT_ERR_CSP_UART_GETC_TIMEOUT CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, 0x100U, 1U)
+
+#define CY_ASSERT(x)                                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(x))                                                                                                      \
+        {                                                                                                              \
+            host_assert_failed(__FILE__, __LINE__);                                                                    \
+        }                                                                                                              \
+    } while (0)
+#define CY_UNUSED_PARAMETER(x) (void)(x)
+#define CY_NOINIT
+#define CY_SECTION(name)
+#define CY_ALIGN(align) __attribute__((aligned(align)))
+
+void host_assert_failed(const char *file, int line);
@@ -0,0 +1,6 @@
+/* Host stand-in for the retarget-io library */
+#pragma once
+
+#include "cyhal.h"
+
+extern cyhal_uart_t cy_retarget_io_uart_obj;
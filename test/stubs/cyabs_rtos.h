@@ -0,0 +1,43 @@
+/* Host stand-in for the RTOS abstraction. The time is simulated, see
+ * host_time_ms in host_test.h. */
+#pragma once
+
+#include "FreeRTOS.h"
+#include "cy_result.h"
+#include "task.h"
+
+typedef void *cy_thread_arg_t;
+typedef uint32_t cy_time_t;
+typedef struct
+{
+    uint32_t count;
+} cy_semaphore_t;
+typedef struct
+{
+    uint32_t count;
+} cy_mutex_t;
+
+typedef enum
+{
+    CY_RTOS_PRIORITY_MIN,
+    CY_RTOS_PRIORITY_LOW,
+    CY_RTOS_PRIORITY_BELOWNORMAL,
+    CY_RTOS_PRIORITY_NORMAL,
+    CY_RTOS_PRIORITY_ABOVENORMAL,
+    CY_RTOS_PRIORITY_HIGH,
+    CY_RTOS_PRIORITY_REALTIME,
+    CY_RTOS_PRIORITY_MAX
+} cy_thread_priority_t;
+
+#define CY_RTOS_NEVER_TIMEOUT (0xFFFFFFFFUL)
+
+#define CY_RTOS_TIMEOUT CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, 0x100U, 2U)
+
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval);
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount);
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *semaphore, cy_time_t timeout_ms, bool in_isr);
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *semaphore, bool in_isr);
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t *mutex);
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t *mutex, cy_time_t timeout_ms);
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t *mutex);
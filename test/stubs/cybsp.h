@@ -0,0 +1,13 @@
+/* Host stand-in for the board support package of CYSBSYSKIT-DEV-01 */
+#pragma once
+
+#include "cyhal.h"
+
+#define CYBSP_I2C_SDA  (60)
+#define CYBSP_I2C_SCL  (61)
+#define CYBSP_USER_LED (111)
+
+#define CYBSP_LED_STATE_ON  (0U)
+#define CYBSP_LED_STATE_OFF (1U)
+
+cy_rslt_t cybsp_init(void);
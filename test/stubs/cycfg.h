@@ -0,0 +1,2 @@
+/* Host stand-in for the generated device configuration */
+#pragma once
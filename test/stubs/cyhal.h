@@ -0,0 +1,107 @@
+/* Host stand-in for the subset of the HAL used by the modules under test */
+#pragma once
+
+#include "cy_result.h"
+
+#define NC (-1)
+
+/* Pins of the PAS CO2 Wing Board on CYSBSYSKIT-DEV-01 */
+#define P5_3  (53)
+#define P9_0  (90)
+#define P9_1  (91)
+#define P10_5 (105)
+
+typedef int cyhal_gpio_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DIR_INPUT,
+    CYHAL_GPIO_DIR_OUTPUT,
+} cyhal_gpio_direction_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DRIVE_NONE,
+    CYHAL_GPIO_DRIVE_STRONG,
+} cyhal_gpio_drive_mode_t;
+
+typedef int cyhal_gpio_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_uart_t;
+
+typedef enum
+{
+    CYHAL_UART_IRQ_NONE = 0,
+    CYHAL_UART_IRQ_RX_NOT_EMPTY = 1 << 8,
+} cyhal_uart_event_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_i2c_t;
+
+typedef struct
+{
+    int unused;
+} cyhal_wdt_t;
+
+typedef enum
+{
+    CYHAL_I2C_MODE_SLAVE,
+    CYHAL_I2C_MODE_MASTER,
+} cyhal_i2c_mode_t;
+
+typedef struct
+{
+    cyhal_i2c_mode_t is_slave;
+    uint16_t address;
+    uint32_t frequencyhal_hz;
+} cyhal_i2c_cfg_t;
+
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin,
+                          cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+
+cy_rslt_t cyhal_uart_putc(cyhal_uart_t *obj, uint32_t value);
+
+cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const void *clk);
+cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg);
+cy_rslt_t cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t address, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t address, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                     uint16_t address,
+                                     uint16_t mem_addr,
+                                     uint16_t mem_addr_size,
+                                     const uint8_t *data,
+                                     uint16_t size,
+                                     uint32_t timeout);
+cy_rslt_t cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                    uint16_t address,
+                                    uint16_t mem_addr,
+                                    uint16_t mem_addr_size,
+                                    uint8_t *data,
+                                    uint16_t size,
+                                    uint32_t timeout);
+
+typedef enum
+{
+    CYHAL_SYSTEM_RESET_NONE = 0,
+    CYHAL_SYSTEM_RESET_WDT = 1 << 0,
+    CYHAL_SYSTEM_RESET_SOFT = 1 << 4,
+} cyhal_reset_reason_t;
+
+cy_rslt_t cyhal_wdt_init(cyhal_wdt_t *obj, uint32_t timeout_ms);
+void cyhal_wdt_kick(cyhal_wdt_t *obj);
+
+uint32_t cyhal_system_get_reset_reason(void);
+void cyhal_system_clear_reset_reason(void);
+
+uint32_t cyhal_system_critical_section_enter(void);
+void cyhal_system_critical_section_exit(uint32_t old_state);
@@ -0,0 +1,131 @@
+/*****************************************************************************
+** File name: em_eeprom_file.c
+**
+** Description: This file implements a file-backed host stand-in of the
+** Emulated EEPROM middleware. The EEPROM content survives the test process,
+** so a test can write a configuration, reinitialize the module like after a
+** reset and read it back. Write failures can be injected.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_em_eeprom.h"
+
+/* Header file for local module */
+#include "host_test.h"
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+const char *host_eeprom_path = "eeprom.bin";
+uint32_t host_eeprom_writes = 0;
+uint32_t host_eeprom_fail_writes = 0;
+
+/*******************************************************************************
+ * Function Name: Cy_Em_EEPROM_Init
+ *******************************************************************************
+ * Summary:
+ *   Creates the backing file filled with zeros if it does not exist, like an
+ *   erased emulated EEPROM.
+ *******************************************************************************/
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Init(const cy_stc_eeprom_config_t *config, cy_stc_eeprom_context_t *context)
+{
+    if ((config == NULL) || (context == NULL) || (config->eepromSize == 0U))
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    context->eepromSize = config->eepromSize;
+
+    FILE *file = fopen(host_eeprom_path, "rb");
+    if (file != NULL)
+    {
+        fclose(file);
+        return CY_EM_EEPROM_SUCCESS;
+    }
+    file = fopen(host_eeprom_path, "wb");
+    if (file == NULL)
+    {
+        return CY_EM_EEPROM_WRITE_FAIL;
+    }
+    for (uint32_t i = 0; i < config->eepromSize; i++)
+    {
+        fputc(0, file);
+    }
+    fclose(file);
+    return CY_EM_EEPROM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_Em_EEPROM_Read
+ *******************************************************************************/
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Read(uint32_t addr,
+                                           void *eepromData,
+                                           uint32_t size,
+                                           cy_stc_eeprom_context_t *context)
+{
+    if ((addr + size) > context->eepromSize)
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    FILE *file = fopen(host_eeprom_path, "rb");
+    if (file == NULL)
+    {
+        return CY_EM_EEPROM_BAD_DATA;
+    }
+    bool read = (fseek(file, (long)addr, SEEK_SET) == 0) && (fread(eepromData, 1U, size, file) == size);
+    fclose(file);
+    return read ? CY_EM_EEPROM_SUCCESS : CY_EM_EEPROM_BAD_DATA;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_Em_EEPROM_Write
+ *******************************************************************************
+ * Summary:
+ *   Writes to the backing file. Fails without changing the file while
+ *   host_eeprom_fail_writes is not 0.
+ *******************************************************************************/
+cy_en_em_eeprom_status_t Cy_Em_EEPROM_Write(uint32_t addr,
+                                            const void *eepromData,
+                                            uint32_t size,
+                                            cy_stc_eeprom_context_t *context)
+{
+    if ((addr + size) > context->eepromSize)
+    {
+        return CY_EM_EEPROM_BAD_PARAM;
+    }
+    if (host_eeprom_fail_writes > 0U)
+    {
+        host_eeprom_fail_writes--;
+        return CY_EM_EEPROM_WRITE_FAIL;
+    }
+    FILE *file = fopen(host_eeprom_path, "r+b");
+    if (file == NULL)
+    {
+        return CY_EM_EEPROM_WRITE_FAIL;
+    }
+    bool written = (fseek(file, (long)addr, SEEK_SET) == 0) && (fwrite(eepromData, 1U, size, file) == size);
+    fclose(file);
+    if (!written)
+    {
+        return CY_EM_EEPROM_WRITE_FAIL;
+    }
+    host_eeprom_writes++;
+    return CY_EM_EEPROM_SUCCESS;
+}
@@ -0,0 +1,281 @@
+/*****************************************************************************
+** File name: host_stubs.c
+**
+** Description: This file implements the host shims of the HAL, RTOS and
+** middleware functions used by the modules under test. Time is simulated and
+** only advances when a test changes host_time_ms or a module delays.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cy_retarget_io.h"
+#include "cyabs_rtos.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "host_test.h"
+
+/* Size of the debug UART capture buffer, holds the hex dump of a full I2C
+ * recording */
+#define HOST_UART_OUTPUT_SIZE (65536U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+uint32_t host_time_ms = 0;
+uint32_t host_reset_reason = CYHAL_SYSTEM_RESET_NONE;
+
+char host_uart_output[HOST_UART_OUTPUT_SIZE];
+size_t host_uart_length = 0;
+
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+uint32_t SystemCoreClock = 100000000UL;
+
+/* Watchdog model, expires when not kicked within the timeout */
+static bool host_wdt_enabled = false;
+static uint32_t host_wdt_timeout = 0;
+static uint32_t host_wdt_last_kick = 0;
+
+/*******************************************************************************
+ * Function Name: host_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT, stops the test.
+ *******************************************************************************/
+void host_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "%s:%d: CY_ASSERT failed\n", file, line);
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+ * Function Name: host_uart_clear
+ *******************************************************************************
+ * Summary:
+ *   Discards the captured UART output.
+ *******************************************************************************/
+void host_uart_clear(void)
+{
+    host_uart_length = 0;
+    host_uart_output[0] = '\0';
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_uart_putc
+ *******************************************************************************
+ * Summary:
+ *   Appends a character to the UART capture buffer. Characters beyond the
+ *   buffer size are dropped.
+ *******************************************************************************/
+cy_rslt_t cyhal_uart_putc(cyhal_uart_t *obj, uint32_t value)
+{
+    if (host_uart_length < (HOST_UART_OUTPUT_SIZE - 1U))
+    {
+        host_uart_output[host_uart_length++] = (char)value;
+        host_uart_output[host_uart_length] = '\0';
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_system_critical_section_enter
+ *******************************************************************************
+ * Summary:
+ *   The modules which use critical sections are tested single threaded.
+ *******************************************************************************/
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return 0U;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_system_critical_section_exit
+ *******************************************************************************/
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_time
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval)
+{
+    *tval = host_time_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_delay_milliseconds
+ *******************************************************************************/
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    host_time_ms += num_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: vTaskDelay
+ *******************************************************************************/
+void vTaskDelay(TickType_t ticks)
+{
+    host_time_ms += ticks;
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetSchedulerState
+ *******************************************************************************
+ * Summary:
+ *   The tests run the modules as if the scheduler had been started.
+ *******************************************************************************/
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return taskSCHEDULER_RUNNING;
+}
+
+/*******************************************************************************
+ * Function Name: uxTaskGetStackHighWaterMark
+ *******************************************************************************
+ * Summary:
+ *   The host has no task stacks, no word is reported as free.
+ *******************************************************************************/
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    return 0U;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_init_semaphore
+ *******************************************************************************/
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    semaphore->count = initcount;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_semaphore
+ *******************************************************************************
+ * Summary:
+ *   Takes the semaphore if it is set, otherwise nothing can set it in a
+ *   single threaded test and the timeout elapses.
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *semaphore, cy_time_t timeout_ms, bool in_isr)
+{
+    if (semaphore->count > 0U)
+    {
+        semaphore->count--;
+        return CY_RSLT_SUCCESS;
+    }
+    host_time_ms += timeout_ms;
+    return CY_RTOS_TIMEOUT;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_set_semaphore
+ *******************************************************************************/
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *semaphore, bool in_isr)
+{
+    semaphore->count++;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_init_mutex
+ *******************************************************************************/
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t *mutex)
+{
+    mutex->count = 0U;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_mutex
+ *******************************************************************************
+ * Summary:
+ *   Takes the mutex. A mutex which is still held would never be released in
+ *   a single threaded test.
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t *mutex, cy_time_t timeout_ms)
+{
+    HOST_CHECK(mutex->count == 0U);
+    mutex->count++;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_set_mutex
+ *******************************************************************************/
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t *mutex)
+{
+    HOST_CHECK(mutex->count == 1U);
+    mutex->count--;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_wdt_init
+ *******************************************************************************/
+cy_rslt_t cyhal_wdt_init(cyhal_wdt_t *obj, uint32_t timeout_ms)
+{
+    host_wdt_enabled = true;
+    host_wdt_timeout = timeout_ms;
+    host_wdt_last_kick = host_time_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_wdt_kick
+ *******************************************************************************/
+void cyhal_wdt_kick(cyhal_wdt_t *obj)
+{
+    HOST_CHECK(!host_wdt_expired());
+    host_wdt_last_kick = host_time_ms;
+}
+
+/*******************************************************************************
+ * Function Name: host_wdt_expired
+ *******************************************************************************
+ * Summary:
+ *   Returns true once the watchdog would have reset the device.
+ *******************************************************************************/
+bool host_wdt_expired(void)
+{
+    return host_wdt_enabled && ((host_time_ms - host_wdt_last_kick) > host_wdt_timeout);
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_system_get_reset_reason
+ *******************************************************************************/
+uint32_t cyhal_system_get_reset_reason(void)
+{
+    return host_reset_reason;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_system_clear_reset_reason
+ *******************************************************************************/
+void cyhal_system_clear_reset_reason(void)
+{
+    host_reset_reason = CYHAL_SYSTEM_RESET_NONE;
+}
@@ -0,0 +1,27 @@
+/* Host stand-in for the PAS CO2 sensor driver. The tests implement the
+ * functions with a sensor model. */
+#pragma once
+
+#include "cyhal.h"
+
+#define MTB_PASCO2_SENSOR_NOT_FOUND    (1U)
+#define MTB_PASCO2_PPM_PENDING         (2U)
+#define MTB_PASCO2_SENSOR_BUSY         (3U)
+#define MTB_PASCO2_VOLTAGE_ERROR       (4U)
+#define MTB_PASCO2_TEMPERATURE_ERROR   (5U)
+#define MTB_PASCO2_COMMUNICATION_ERROR (6U)
+#define MTB_PASCO2_CONFIGURATION_ERROR (7U)
+
+typedef struct
+{
+    cyhal_i2c_t *i2c;
+} mtb_pasco2_context_t;
+
+typedef struct
+{
+    uint16_t measurement_period;
+} mtb_pasco2_config_t;
+
+cy_rslt_t mtb_pasco2_init(mtb_pasco2_context_t *context, cyhal_i2c_t *i2c);
+cy_rslt_t mtb_pasco2_get_ppm(mtb_pasco2_context_t *context, uint16_t *ppm);
+cy_rslt_t mtb_pasco2_set_config(mtb_pasco2_context_t *context, const mtb_pasco2_config_t *config);
@@ -0,0 +1,13 @@
+/* Host stand-in for the FreeRTOS task API. The tick is 1 ms, a delay
+ * advances the simulated time. */
+#pragma once
+
+#include "FreeRTOS.h"
+
+#define taskSCHEDULER_SUSPENDED   ((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING     ((BaseType_t)2)
+
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskGetSchedulerState(void);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
@@ -0,0 +1,238 @@
+/*****************************************************************************
+** File name: test_adaptive_period.c
+**
+** Description: Host test of the adaptive measurement period controller. It
+** checks the control rules and replays a simulated office day to compare
+** the adaptive period with the fixed 10 s period: number of samples and the
+** latency until a crossing of the ventilation threshold is seen.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_adaptive_period.h"
+
+/* Length of the simulated trace in s */
+#define TRACE_LENGTH (24U * 3600U)
+/* Outdoor CO2 level in ppm */
+#define TRACE_OUTDOOR (420.0)
+/* CO2 generation of one person in ppm/s for a 50 m3 room */
+#define TRACE_PERSON_RATE (0.104)
+/* Air changes per s */
+#define TRACE_AIR_CHANGE (3.0 / 3600.0)
+/* Ventilation threshold in ppm whose crossings have to be detected */
+#define TRACE_THRESHOLD (1000U)
+/* Maximum number of threshold crossings in the trace */
+#define TRACE_MAX_CROSSINGS (16U)
+
+/* Fixed period of the application without adaptation in s */
+#define FIXED_PERIOD (10U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint32_t start; /* s since midnight */
+    uint32_t people;
+} occupancy_t;
+
+typedef struct
+{
+    uint32_t samples;
+    uint32_t max_latency; /* longest time from a crossing until it was seen, in s */
+    uint32_t total_latency;
+} strategy_result_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Occupancy of a meeting room */
+static const occupancy_t trace_occupancy[] = {
+    {0U, 0U},
+    {8U * 3600U, 3U},
+    {10U * 3600U, 8U},
+    {11U * 3600U + 1800U, 3U},
+    {12U * 3600U, 0U},
+    {13U * 3600U, 8U},
+    {14U * 3600U, 3U},
+    {17U * 3600U, 0U},
+};
+
+/* Simulated CO2 value for every second of the trace */
+static uint16_t trace_ppm[TRACE_LENGTH];
+static uint32_t trace_crossings[TRACE_MAX_CROSSINGS];
+static uint32_t trace_crossing_count;
+
+/*******************************************************************************
+ * Function Name: trace_generate
+ *******************************************************************************
+ * Summary:
+ *   Integrates the CO2 mass balance of the room with a step of 1 s and
+ *   records the times at which the value crosses the threshold.
+ *******************************************************************************/
+static void trace_generate(void)
+{
+    double co2 = TRACE_OUTDOOR;
+    uint32_t people = 0;
+    uint32_t next = 0;
+
+    for (uint32_t t = 0; t < TRACE_LENGTH; t++)
+    {
+        if ((next < (sizeof(trace_occupancy) / sizeof(trace_occupancy[0]))) && (trace_occupancy[next].start == t))
+        {
+            people = trace_occupancy[next++].people;
+        }
+        co2 += (people * TRACE_PERSON_RATE) - (TRACE_AIR_CHANGE * (co2 - TRACE_OUTDOOR));
+        trace_ppm[t] = (uint16_t)(co2 + 0.5);
+
+        if ((t > 0U) && ((trace_ppm[t - 1U] >= TRACE_THRESHOLD) != (trace_ppm[t] >= TRACE_THRESHOLD)))
+        {
+            HOST_CHECK(trace_crossing_count < TRACE_MAX_CROSSINGS);
+            trace_crossings[trace_crossing_count++] = t;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: strategy_run
+ *******************************************************************************
+ * Summary:
+ *   Samples the trace with a fixed period or with the adaptive controller and
+ *   measures the sample count and the detection latency of every crossing.
+ *******************************************************************************/
+static strategy_result_t strategy_run(bool adaptive)
+{
+    strategy_result_t result = {0};
+    pasco2_adaptive_period_t ctrl;
+    pasco2_adaptive_period_init(&ctrl, NULL, PASCO2_ADAPTIVE_PERIOD_MIN);
+
+    uint32_t crossing = 0;
+    bool above = false;
+    uint32_t previous = 0;
+    for (uint32_t t = 0; t < TRACE_LENGTH;)
+    {
+        uint16_t ppm = trace_ppm[t];
+        result.samples++;
+
+        /* A sample on the other side of the threshold detects all crossings
+         * since the previous sample */
+        if ((ppm >= TRACE_THRESHOLD) != above)
+        {
+            above = !above;
+            while ((crossing < trace_crossing_count) && (trace_crossings[crossing] <= t))
+            {
+                uint32_t latency = t - trace_crossings[crossing++];
+                result.total_latency += latency;
+                if (latency > result.max_latency)
+                {
+                    result.max_latency = latency;
+                }
+            }
+        }
+
+        uint32_t period = FIXED_PERIOD;
+        if (adaptive)
+        {
+            period = pasco2_adaptive_period_update(&ctrl, ppm, (t - previous) * 1000U);
+        }
+        previous = t;
+        t += period;
+    }
+    HOST_CHECK(crossing == trace_crossing_count);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: test_control_rules
+ *******************************************************************************
+ * Summary:
+ *   Checks clamping, the drop to the shortest period on fast changes and
+ *   stretching on stable values.
+ *******************************************************************************/
+static void test_control_rules(void)
+{
+    pasco2_adaptive_period_t ctrl;
+
+    pasco2_adaptive_period_init(&ctrl, NULL, 1U);
+    HOST_CHECK(ctrl.period == PASCO2_ADAPTIVE_PERIOD_MIN);
+    pasco2_adaptive_period_init(&ctrl, NULL, 60000U);
+    HOST_CHECK(ctrl.period == PASCO2_ADAPTIVE_PERIOD_MAX);
+
+    /* Stable readings stretch the period up to the maximum */
+    pasco2_adaptive_period_init(&ctrl, NULL, PASCO2_ADAPTIVE_PERIOD_MIN);
+    uint16_t period = pasco2_adaptive_period_update(&ctrl, 500U, 10000U);
+    for (uint32_t i = 0; i < 100U; i++)
+    {
+        period = pasco2_adaptive_period_update(&ctrl, 500U, period * 1000U);
+    }
+    HOST_CHECK(period == PASCO2_ADAPTIVE_PERIOD_MAX);
+
+    /* A fast change selects the shortest period immediately */
+    uint16_t fast = pasco2_adaptive_period_update(&ctrl, 500U + (period / 60U) * 100U, period * 1000U);
+    HOST_CHECK(fast == PASCO2_ADAPTIVE_PERIOD_MIN);
+
+    /* Rates in the hysteresis band keep the period */
+    pasco2_adaptive_period_init(&ctrl, NULL, 40U);
+    (void)pasco2_adaptive_period_update(&ctrl, 500U, 40000U);
+    ctrl.rate = 12;
+    HOST_CHECK(pasco2_adaptive_period_update(&ctrl, 508U, 40000U) == 40U);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    test_control_rules();
+
+    trace_generate();
+    HOST_CHECK(trace_crossing_count >= 2U);
+
+    strategy_result_t fixed = strategy_run(false);
+    strategy_result_t adaptive = strategy_run(true);
+
+    printf("Occupancy trace of %u h, %u crossings of %u ppm\n",
+           TRACE_LENGTH / 3600U,
+           trace_crossing_count,
+           TRACE_THRESHOLD);
+    printf("%-10s %8s %16s %16s\n", "Period", "Samples", "Max latency s", "Mean latency s");
+    printf("%-10s %8u %16u %16u\n",
+           "fixed",
+           fixed.samples,
+           fixed.max_latency,
+           fixed.total_latency / trace_crossing_count);
+    printf("%-10s %8u %16u %16u\n",
+           "adaptive",
+           adaptive.samples,
+           adaptive.max_latency,
+           adaptive.total_latency / trace_crossing_count);
+
+    /* The adaptive period needs far fewer samples. A crossing is seen at
+     * most a few fixed periods later than with the fixed period */
+    HOST_CHECK((adaptive.samples * 5U) < fixed.samples);
+    HOST_CHECK(fixed.max_latency < FIXED_PERIOD);
+    HOST_CHECK(adaptive.max_latency <= (3U * FIXED_PERIOD));
+    HOST_CHECK(adaptive.total_latency <= (2U * FIXED_PERIOD * trace_crossing_count));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*****************************************************************************
+** File name: test_config_store.c
+**
+** Description: Host test of the persistent configuration store on a
+** file-backed Emulated EEPROM. It checks the record encoding against an
+** independent CRC-32, the restore after a simulated reset, the coalescing of
+** edits, and that damaged or foreign records and failed writes are handled.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_config_store.h"
+
+/* Size of the encoded record: magic, version, length, data and CRC */
+#define RECORD_SIZE (16U)
+/* Offset of the CRC in the encoded record */
+#define RECORD_CRC_OFFSET (12U)
+
+/*******************************************************************************
+ * Function Name: reference_crc32
+ *******************************************************************************
+ * Summary:
+ *   Bytewise table-free CRC-32 written independently of the module.
+ *******************************************************************************/
+static uint32_t reference_crc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            uint32_t mask = 0U - (crc & 1U);
+            crc = (crc >> 1) ^ (0xEDB88320UL & mask);
+        }
+    }
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+/*******************************************************************************
+ * Function Name: eeprom_load
+ *******************************************************************************
+ * Summary:
+ *   Reads the encoded record from the backing file.
+ *******************************************************************************/
+static void eeprom_load(uint8_t record[RECORD_SIZE])
+{
+    FILE *file = fopen(host_eeprom_path, "rb");
+    HOST_CHECK(file != NULL);
+    HOST_CHECK(fread(record, 1U, RECORD_SIZE, file) == RECORD_SIZE);
+    fclose(file);
+}
+
+/*******************************************************************************
+ * Function Name: eeprom_store
+ *******************************************************************************
+ * Summary:
+ *   Overwrites the encoded record in the backing file.
+ *******************************************************************************/
+static void eeprom_store(const uint8_t record[RECORD_SIZE])
+{
+    FILE *file = fopen(host_eeprom_path, "r+b");
+    HOST_CHECK(file != NULL);
+    HOST_CHECK(fwrite(record, 1U, RECORD_SIZE, file) == RECORD_SIZE);
+    fclose(file);
+}
+
+/*******************************************************************************
+ * Function Name: encode
+ *******************************************************************************
+ * Summary:
+ *   Encodes a record in the little-endian layout documented in
+ *   pasco2_config_store.c.
+ *******************************************************************************/
+static void encode(uint8_t record[RECORD_SIZE], uint16_t version, uint16_t period, uint8_t adaptive)
+{
+    const uint8_t header[] = {'P', 'C', 'F', 'G', (uint8_t)version, (uint8_t)(version >> 8), 4U, 0U};
+    memcpy(record, header, sizeof(header));
+    record[8] = (uint8_t)period;
+    record[9] = (uint8_t)(period >> 8);
+    record[10] = adaptive;
+    record[11] = 0U;
+    uint32_t crc = reference_crc32(record, RECORD_CRC_OFFSET);
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        record[RECORD_CRC_OFFSET + i] = (uint8_t)(crc >> (8U * i));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: reboot
+ *******************************************************************************
+ * Summary:
+ *   Initializes the module again like after a reset and returns the restored
+ *   configuration.
+ *******************************************************************************/
+static bool reboot(pasco2_config_store_data_t *data)
+{
+    HOST_CHECK(pasco2_config_store_init() == CY_RSLT_SUCCESS);
+    return pasco2_config_store_get(data);
+}
+
+/*******************************************************************************
+ * Function Name: settle
+ *******************************************************************************
+ * Summary:
+ *   Calls the periodic processing once per second for the given time.
+ *******************************************************************************/
+static void settle(uint32_t duration_ms)
+{
+    for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed += 1000U)
+    {
+        host_time_ms += 1000U;
+        pasco2_config_store_process();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    pasco2_config_store_data_t data;
+    uint8_t record[RECORD_SIZE];
+    uint8_t expected[RECORD_SIZE];
+
+    static const uint8_t check[] = "123456789";
+    HOST_CHECK(reference_crc32(check, sizeof(check) - 1U) == 0xCBF43926UL);
+
+    host_eeprom_path = "test_config_store.bin";
+    remove(host_eeprom_path);
+
+    /* Erased EEPROM: no configuration */
+    HOST_CHECK(!reboot(&data));
+    HOST_CHECK(data.measurement_period == 0U);
+
+    /* Edits within the commit delay are coalesced into one write */
+    pasco2_config_store_set_measurement_period(30U);
+    settle(5000U);
+    pasco2_config_store_set_measurement_period(60U);
+    pasco2_config_store_set_adaptive_period(true);
+    settle(PASCO2_CONFIG_STORE_COMMIT_DELAY - 1000U);
+    HOST_CHECK(host_eeprom_writes == 0U);
+    settle(1000U);
+    HOST_CHECK(host_eeprom_writes == 1U);
+
+    /* The record has the documented layout */
+    eeprom_load(record);
+    encode(expected, PASCO2_CONFIG_STORE_VERSION, 60U, 1U);
+    HOST_CHECK(memcmp(record, expected, RECORD_SIZE) == 0);
+
+    /* Restored after a reset, unchanged values are not written again */
+    HOST_CHECK(reboot(&data));
+    HOST_CHECK(data.measurement_period == 60U);
+    HOST_CHECK(data.adaptive_period == 1U);
+    pasco2_config_store_set_measurement_period(60U);
+    settle(2U * PASCO2_CONFIG_STORE_COMMIT_DELAY);
+    HOST_CHECK(host_eeprom_writes == 1U);
+
+    /* A failed write is retried after the next commit delay */
+    host_eeprom_fail_writes = 1U;
+    pasco2_config_store_set_adaptive_period(false);
+    settle(PASCO2_CONFIG_STORE_COMMIT_DELAY);
+    HOST_CHECK(host_eeprom_writes == 1U);
+    HOST_CHECK(host_eeprom_fail_writes == 0U);
+    settle(PASCO2_CONFIG_STORE_COMMIT_DELAY);
+    HOST_CHECK(host_eeprom_writes == 2U);
+    HOST_CHECK(reboot(&data));
+    HOST_CHECK((data.measurement_period == 60U) && (data.adaptive_period == 0U));
+
+    /* A record written by the encoder of the test is accepted */
+    encode(record, PASCO2_CONFIG_STORE_VERSION, 4095U, 0U);
+    eeprom_store(record);
+    HOST_CHECK(reboot(&data));
+    HOST_CHECK(data.measurement_period == 4095U);
+
+    /* A flipped bit, a foreign version or a wrong length are rejected */
+    record[8] ^= 0x01U;
+    eeprom_store(record);
+    HOST_CHECK(!reboot(&data));
+    encode(record, PASCO2_CONFIG_STORE_VERSION + 1U, 120U, 0U);
+    eeprom_store(record);
+    HOST_CHECK(!reboot(&data));
+    encode(record, PASCO2_CONFIG_STORE_VERSION, 120U, 0U);
+    record[6] = 8U;
+    uint32_t crc = reference_crc32(record, RECORD_CRC_OFFSET);
+    memcpy(&record[RECORD_CRC_OFFSET], &crc, sizeof(crc));
+    eeprom_store(record);
+    HOST_CHECK(!reboot(&data));
+
+    /* A rejected record is replaced by the next change */
+    pasco2_config_store_set_measurement_period(20U);
+    settle(PASCO2_CONFIG_STORE_COMMIT_DELAY);
+    HOST_CHECK(reboot(&data));
+    HOST_CHECK(data.measurement_period == 20U);
+
+    remove(host_eeprom_path);
+    return EXIT_SUCCESS;
+}
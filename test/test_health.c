@@ -0,0 +1,189 @@
+/*****************************************************************************
+** File name: test_health.c
+**
+** Description: Host test of the task health monitor. It checks the loop time
+** histogram and simulates a stalled sensor job: the monitor has to stop
+** feeding the watchdog, the watchdog model has to expire, and the next boot
+** has to report the failed task.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_health.h"
+
+/* Measurement period of the simulated sensor job in ms */
+#define SENSOR_PERIOD (10000U)
+/* Time step of the simulation in ms */
+#define SIMULATION_STEP (100U)
+
+/*******************************************************************************
+ * Function Name: histogram_row
+ *******************************************************************************
+ * Summary:
+ *   Prints the statistics and reads the histogram row of a task from them.
+ *******************************************************************************/
+static void histogram_row(const char *name, uint32_t *misses, uint32_t histogram[PASCO2_HEALTH_HISTOGRAM_BUCKETS])
+{
+    host_uart_clear();
+    pasco2_health_print_statistics();
+    const char *row = strstr(host_uart_output, name);
+    HOST_CHECK(row != NULL);
+    row += strlen(name);
+
+    unsigned int values[3 + PASCO2_HEALTH_HISTOGRAM_BUCKETS];
+    int parsed = sscanf(row,
+                        "%u %u %u %u %u %u %u %u %u",
+                        &values[0],
+                        &values[1],
+                        &values[2],
+                        &values[3],
+                        &values[4],
+                        &values[5],
+                        &values[6],
+                        &values[7],
+                        &values[8]);
+    HOST_CHECK(parsed == (3 + (int)PASCO2_HEALTH_HISTOGRAM_BUCKETS));
+    *misses = values[2];
+    for (uint32_t i = 0; i < PASCO2_HEALTH_HISTOGRAM_BUCKETS; i++)
+    {
+        histogram[i] = values[3U + i];
+    }
+}
+
+/*******************************************************************************
+ * Function Name: histogram_total
+ *******************************************************************************/
+static uint32_t histogram_total(const uint32_t histogram[PASCO2_HEALTH_HISTOGRAM_BUCKETS])
+{
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < PASCO2_HEALTH_HISTOGRAM_BUCKETS; i++)
+    {
+        total += histogram[i];
+    }
+    return total;
+}
+
+/*******************************************************************************
+ * Function Name: simulate
+ *******************************************************************************
+ * Summary:
+ *   Runs the executor heartbeat every check period, the sensor job heartbeat
+ *   every measurement period until stall_at, and the health check every
+ *   check period. Stops when the watchdog expires or at the end time.
+ *
+ * Return:
+ *   time of the last sensor job heartbeat
+ *******************************************************************************/
+static uint32_t simulate(uint32_t end, uint32_t stall_at)
+{
+    uint32_t last_sensor = host_time_ms;
+    while ((host_time_ms < end) && !host_wdt_expired())
+    {
+        host_time_ms += SIMULATION_STEP;
+        if ((host_time_ms % PASCO2_HEALTH_CHECK_PERIOD) == 0U)
+        {
+            pasco2_health_heartbeat(PASCO2_HEALTH_EXECUTOR, PASCO2_HEALTH_CHECK_PERIOD);
+        }
+        if (((host_time_ms % SENSOR_PERIOD) == 0U) && (host_time_ms < stall_at))
+        {
+            pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, SENSOR_PERIOD);
+            last_sensor = host_time_ms;
+        }
+        if ((host_time_ms % PASCO2_HEALTH_CHECK_PERIOD) == 0U)
+        {
+            (void)pasco2_health_check();
+        }
+    }
+    return last_sensor;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    uint32_t misses;
+    uint32_t histogram[PASCO2_HEALTH_HISTOGRAM_BUCKETS];
+
+    /* Power-on */
+    host_reset_reason = CYHAL_SYSTEM_RESET_NONE;
+    pasco2_health_init();
+    HOST_CHECK(strstr(host_uart_output, "Watchdog reset") == NULL);
+    cyhal_wdt_t wdt;
+    HOST_CHECK(cyhal_wdt_init(&wdt, PASCO2_HEALTH_WDT_TIMEOUT) == CY_RSLT_SUCCESS);
+
+    /* Healthy minute: every loop ends within its deadline */
+    (void)simulate(60000U, UINT32_MAX);
+    HOST_CHECK(!host_wdt_expired());
+    histogram_row("CO2 sensor", &misses, histogram);
+    HOST_CHECK(misses == 0U);
+    HOST_CHECK(histogram_total(histogram) == 6U);
+    HOST_CHECK(histogram[0] == 6U);
+
+    /* Loops which are followed immediately by the next one announce a
+     * deadline of 0. They are not added to the histogram, the loop after
+     * them is. */
+    pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, 0U);
+    host_time_ms += 50U;
+    pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, 0U);
+    host_time_ms += 50U;
+    pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, SENSOR_PERIOD);
+    (void)simulate(host_time_ms + SENSOR_PERIOD, 0U);
+    pasco2_health_heartbeat(PASCO2_HEALTH_SENSOR_JOB, SENSOR_PERIOD);
+    HOST_CHECK(pasco2_health_check());
+    histogram_row("CO2 sensor", &misses, histogram);
+    HOST_CHECK(misses == 0U);
+    HOST_CHECK(histogram_total(histogram) == 8U);
+    HOST_CHECK(histogram[0] == 8U);
+
+    /* The sensor job stalls: the monitor stops feeding the watchdog once the
+     * deadline and margin have passed, and the watchdog expires */
+    host_uart_clear();
+    uint32_t last_sensor = simulate(host_time_ms + 120000U, host_time_ms);
+    HOST_CHECK(host_wdt_expired());
+    HOST_CHECK(strstr(host_uart_output, "CO2 sensor task missed its deadline") != NULL);
+    uint32_t detection = host_time_ms - last_sensor;
+    printf("Stalled sensor job reset after %u ms (deadline %u ms, margin %u ms, watchdog %u ms)\n",
+           (unsigned int)detection,
+           SENSOR_PERIOD,
+           PASCO2_HEALTH_DEADLINE_MARGIN,
+           PASCO2_HEALTH_WDT_TIMEOUT);
+    HOST_CHECK(detection > (SENSOR_PERIOD + PASCO2_HEALTH_DEADLINE_MARGIN));
+    HOST_CHECK(detection <= (SENSOR_PERIOD + PASCO2_HEALTH_DEADLINE_MARGIN + PASCO2_HEALTH_CHECK_PERIOD +
+                             PASCO2_HEALTH_WDT_TIMEOUT + SIMULATION_STEP));
+
+    /* Next boot after the watchdog reset reports the failed task */
+    host_reset_reason = CYHAL_SYSTEM_RESET_WDT;
+    host_uart_clear();
+    pasco2_health_init();
+    HOST_CHECK(strstr(host_uart_output, "Watchdog reset: CO2 sensor task missed its deadline") != NULL);
+    host_uart_clear();
+    pasco2_health_print_statistics();
+    HOST_CHECK(strstr(host_uart_output, "Boot count: 2, watchdog resets: 1") != NULL);
+    HOST_CHECK(strstr(host_uart_output, "failed task: CO2 sensor") != NULL);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,472 @@
+/*****************************************************************************
+** File name: test_i2c_session.c
+**
+** Description: Host test of the I2C recording and replay. A model of the
+** transfers of the sensor driver runs through the register cache like on the
+** target. Built with PASCO2_I2C_RECORD_ENABLED, it talks to a register model
+** of the sensor which reports a communication error after a few hundred
+** measurements. A manual dump on the way must not stop the recording. The
+** test checks the frozen ring against the transfers on the bus and
+** writes the terminal dump to the file given as argument. The dump is
+** converted by scripts/pasco2_i2c_session.py and the test is built again with
+** PASCO2_I2C_REPLAY_ENABLED, where the driver model has to see the recorded
+** values and the communication error without the sensor model.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stddef.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_i2c_record.h"
+#include "pasco2_regcache.h"
+
+/* Measurement period of the driver model in ms */
+#define MEASUREMENT_PERIOD (10000U)
+/* Measurement at which the sensor model reports a communication error */
+#define ERROR_MEASUREMENT (200U)
+/* Measurement after which the recording is dumped manually */
+#define DUMP_MEASUREMENT (50U)
+/* Measurements of the driver model after the communication error */
+#define MEASUREMENTS_AFTER_ERROR (3U)
+/* Number of transfers logged by the sensor model */
+#define BUS_LOG_SIZE (2048U)
+/* CO2 value of the sensor model in the given measurement */
+#define MODEL_PPM(measurement) ((uint16_t)(400U + ((measurement) * 7U) % 1000U))
+
+/* Sensor status and measurement status bits */
+#define SENS_STS_ICCER (0x10U)
+#define MEAS_STS_DRDY  (0x10U)
+#define MEAS_STS_INT_CLR (0x02U)
+
+/* Results of the driver model */
+#define DRIVER_PPM_READY           (0U)
+#define DRIVER_PPM_PENDING         (1U)
+#define DRIVER_COMMUNICATION_ERROR (2U)
+
+/* Result which freezes the recording, like MTB_PASCO2_COMMUNICATION_ERROR */
+#define COMMUNICATION_ERROR_RESULT (CY_RSLT_CREATE(CY_RSLT_TYPE_WARNING, 0x01U, 0x04U))
+
+/*******************************************************************************
+ * Functions of the register cache which replace the HAL functions
+ *******************************************************************************/
+cy_rslt_t __wrap_cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t __wrap_cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t __wrap_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout);
+
+/*******************************************************************************
+ * Function Name: driver_read
+ *******************************************************************************
+ * Summary:
+ *   Reads registers with an address write and a read.
+ *******************************************************************************/
+static void driver_read(uint8_t reg, uint8_t *data, uint16_t size)
+{
+    HOST_CHECK(__wrap_cyhal_i2c_master_write(NULL, PASCO2_REGCACHE_I2C_ADDRESS, &reg, 1U, 0U, false) ==
+               CY_RSLT_SUCCESS);
+    HOST_CHECK(__wrap_cyhal_i2c_master_read(NULL, PASCO2_REGCACHE_I2C_ADDRESS, data, size, 0U, true) ==
+               CY_RSLT_SUCCESS);
+}
+
+/*******************************************************************************
+ * Function Name: driver_write
+ *******************************************************************************
+ * Summary:
+ *   Writes a register.
+ *******************************************************************************/
+static void driver_write(uint8_t reg, uint8_t value)
+{
+    HOST_CHECK(__wrap_cyhal_i2c_master_mem_write(NULL, PASCO2_REGCACHE_I2C_ADDRESS, reg, 1U, &value, 1U, 0U) ==
+               CY_RSLT_SUCCESS);
+}
+
+/*******************************************************************************
+ * Function Name: driver_init
+ *******************************************************************************
+ * Summary:
+ *   Resets the sensor, checks it and starts continuous measurements.
+ *******************************************************************************/
+static void driver_init(void)
+{
+    uint8_t value;
+    driver_write(PASCO2_REG_SENS_RST, 0xA3U);
+    driver_read(PASCO2_REG_PROD_ID, &value, 1U);
+    HOST_CHECK(value != 0U);
+    const uint8_t rate[] = {PASCO2_REG_MEAS_RATE_H, 0x00U, (uint8_t)(MEASUREMENT_PERIOD / 1000U)};
+    HOST_CHECK(__wrap_cyhal_i2c_master_write(NULL, PASCO2_REGCACHE_I2C_ADDRESS, rate, sizeof(rate), 0U, true) ==
+               CY_RSLT_SUCCESS);
+    driver_write(PASCO2_REG_MEAS_CFG, 0x02U);
+}
+
+/*******************************************************************************
+ * Function Name: driver_get_ppm
+ *******************************************************************************
+ * Summary:
+ *   Checks the sensor status and reads a new CO2 value, like
+ *   mtb_pasco2_get_ppm.
+ *******************************************************************************/
+static uint32_t driver_get_ppm(uint16_t *ppm)
+{
+    uint8_t value[2];
+    driver_read(PASCO2_REG_SENS_STS, value, 1U);
+    if ((value[0] & SENS_STS_ICCER) != 0U)
+    {
+        return DRIVER_COMMUNICATION_ERROR;
+    }
+    driver_read(PASCO2_REG_MEAS_STS, value, 1U);
+    if ((value[0] & MEAS_STS_DRDY) == 0U)
+    {
+        return DRIVER_PPM_PENDING;
+    }
+    driver_read(PASCO2_REG_CO2PPM_H, value, 2U);
+    *ppm = (uint16_t)((value[0] << 8) | value[1]);
+    driver_write(PASCO2_REG_MEAS_STS, MEAS_STS_INT_CLR);
+    return DRIVER_PPM_READY;
+}
+
+#if defined(PASCO2_I2C_RECORD_ENABLED)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+extern pasco2_i2c_recording_t pasco2_i2c_recording;
+
+/* Register model of the sensor and transfers seen on the bus */
+static struct
+{
+    uint8_t regs[PASCO2_REG_COUNT];
+    uint8_t pointer;
+    uint32_t measurement;
+    uint32_t transfers;
+    pasco2_i2c_record_t log[BUS_LOG_SIZE];
+} model;
+
+/*******************************************************************************
+ * Function Name: model_log
+ *******************************************************************************
+ * Summary:
+ *   Logs a transfer in the layout of the recording.
+ *******************************************************************************/
+static void model_log(uint8_t op, uint16_t mem_addr, const uint8_t *data, uint16_t size)
+{
+    HOST_CHECK(model.transfers < BUS_LOG_SIZE);
+    pasco2_i2c_record_t *record = &model.log[model.transfers++];
+    *record = (pasco2_i2c_record_t){.timestamp = host_time_ms,
+                                    .op = op,
+                                    .address = PASCO2_REGCACHE_I2C_ADDRESS,
+                                    .mem_addr = (uint8_t)mem_addr,
+                                    .size = (uint8_t)size};
+    memcpy(record->data, data, (size < PASCO2_I2C_RECORD_DATA_SIZE) ? size : PASCO2_I2C_RECORD_DATA_SIZE);
+}
+
+/*******************************************************************************
+ * Function Name: model_access
+ *******************************************************************************
+ * Summary:
+ *   Reads or writes registers from the address pointer on.
+ *******************************************************************************/
+static void model_access(uint8_t *read_data, const uint8_t *write_data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++, model.pointer++)
+    {
+        HOST_CHECK(model.pointer < PASCO2_REG_COUNT);
+        if (read_data != NULL)
+        {
+            read_data[i] = model.regs[model.pointer];
+        }
+        else if (model.pointer == PASCO2_REG_SENS_RST)
+        {
+            memset(model.regs, 0, sizeof(model.regs));
+            model.regs[PASCO2_REG_PROD_ID] = 0x42U;
+        }
+        else if ((model.pointer == PASCO2_REG_MEAS_STS) && ((write_data[i] & MEAS_STS_INT_CLR) != 0U))
+        {
+            model.regs[PASCO2_REG_MEAS_STS] &= (uint8_t)~MEAS_STS_DRDY;
+        }
+        else
+        {
+            model.regs[model.pointer] = write_data[i];
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: model_measure
+ *******************************************************************************
+ * Summary:
+ *   Completes a measurement of the sensor model.
+ *******************************************************************************/
+static void model_measure(void)
+{
+    model.measurement++;
+    uint16_t ppm = MODEL_PPM(model.measurement);
+    model.regs[PASCO2_REG_CO2PPM_H] = (uint8_t)(ppm >> 8);
+    model.regs[PASCO2_REG_CO2PPM_L] = (uint8_t)ppm;
+    model.regs[PASCO2_REG_MEAS_STS] |= MEAS_STS_DRDY;
+    if (model.measurement == ERROR_MEASUREMENT)
+    {
+        model.regs[PASCO2_REG_SENS_STS] |= SENS_STS_ICCER;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_write
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    model_log(PASCO2_I2C_OP_WRITE | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), 0U, data, size);
+    model.pointer = data[0];
+    model_access(NULL, &data[1], size - 1U);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    model_access(data, NULL, size);
+    model_log(PASCO2_I2C_OP_READ | (send_stop ? 0U : PASCO2_I2C_OP_NO_STOP), 0U, data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_write
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout)
+{
+    model_log(PASCO2_I2C_OP_MEM_WRITE, mem_addr, data, size);
+    model.pointer = (uint8_t)mem_addr;
+    model_access(NULL, data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout)
+{
+    model.pointer = (uint8_t)mem_addr;
+    model_access(data, NULL, size);
+    model_log(PASCO2_I2C_OP_MEM_READ, mem_addr, data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: check_record
+ *******************************************************************************
+ * Summary:
+ *   Compares a record with a transfer logged by the sensor model.
+ *******************************************************************************/
+static void check_record(const pasco2_i2c_record_t *record, const pasco2_i2c_record_t *logged)
+{
+    HOST_CHECK(record->timestamp == logged->timestamp);
+    HOST_CHECK(record->result == CY_RSLT_SUCCESS);
+    HOST_CHECK(record->op == logged->op);
+    HOST_CHECK(record->address == logged->address);
+    HOST_CHECK(record->mem_addr == logged->mem_addr);
+    HOST_CHECK(record->size == logged->size);
+    HOST_CHECK(memcmp(record->data, logged->data, logged->size) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: check_dump
+ *******************************************************************************
+ * Summary:
+ *   Parses the hex dump printed on the terminal back into bytes and compares
+ *   them with the recording.
+ *******************************************************************************/
+static void check_dump(const char *dump)
+{
+    const char *begin = strstr(dump, "PASCO2-I2C-BEGIN\r\n");
+    const char *end = strstr(dump, "\r\nPASCO2-I2C-END");
+    HOST_CHECK((begin != NULL) && (end != NULL));
+
+    const uint8_t *recording = (const uint8_t *)&pasco2_i2c_recording;
+    size_t length = 0;
+    for (const char *c = begin + strlen("PASCO2-I2C-BEGIN\r\n"); c < end;)
+    {
+        unsigned int byte;
+        if ((*c == '\r') || (*c == '\n'))
+        {
+            c++;
+            continue;
+        }
+        HOST_CHECK(sscanf(c, "%2x", &byte) == 1);
+        HOST_CHECK(byte == recording[length]);
+        length++;
+        c += 2;
+    }
+    HOST_CHECK(length == offsetof(pasco2_i2c_recording_t, records) + sizeof(pasco2_i2c_recording.records));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Records the session and writes the terminal dump to argv[1].
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint16_t ppm = 0;
+    uint32_t after_error = 0;
+    uint32_t recorded = 0;
+
+    driver_init();
+    while (after_error <= MEASUREMENTS_AFTER_ERROR)
+    {
+        host_time_ms += MEASUREMENT_PERIOD;
+        model_measure();
+        uint32_t status = driver_get_ppm(&ppm);
+        if (status == DRIVER_COMMUNICATION_ERROR)
+        {
+            /* Like the sensor job: the ring keeps the transfers up to the
+             * error */
+            if (after_error == 0U)
+            {
+                pasco2_i2c_record_freeze(COMMUNICATION_ERROR_RESULT);
+                recorded = model.transfers;
+            }
+            after_error++;
+        }
+        else
+        {
+            HOST_CHECK(status == DRIVER_PPM_READY);
+            HOST_CHECK(ppm == MODEL_PPM(model.measurement));
+        }
+
+        /* A manual dump pauses the recording only while it prints */
+        if (model.measurement == DUMP_MEASUREMENT)
+        {
+            host_uart_clear();
+            pasco2_i2c_record_dump();
+            HOST_CHECK(strstr(host_uart_output, "PASCO2-I2C-END\r\n") != NULL);
+            HOST_CHECK(strstr(host_uart_output, " 0 after the freeze by result 0x00000000") != NULL);
+            HOST_CHECK(pasco2_i2c_recording.frozen == 0U);
+            HOST_CHECK(pasco2_i2c_recording.trigger == CY_RSLT_SUCCESS);
+            HOST_CHECK(pasco2_i2c_recording.count == model.transfers);
+        }
+    }
+
+    /* The recording holds the prologue and the latest transfers before the
+     * error, later transfers are only counted */
+    pasco2_i2c_recording_t *recording = &pasco2_i2c_recording;
+    HOST_CHECK(recorded > PASCO2_I2C_RECORD_TRANSFERS);
+    HOST_CHECK(recording->count == recorded);
+    HOST_CHECK(recording->dropped == (model.transfers - recorded));
+    HOST_CHECK(recording->frozen == 1U);
+    HOST_CHECK(recording->trigger == COMMUNICATION_ERROR_RESULT);
+    for (uint32_t i = 0; i < PASCO2_I2C_RECORD_PROLOGUE; i++)
+    {
+        check_record(&recording->records[i], &model.log[i]);
+    }
+    const uint32_t ring = PASCO2_I2C_RECORD_TRANSFERS - PASCO2_I2C_RECORD_PROLOGUE;
+    for (uint32_t i = recorded - ring; i < recorded; i++)
+    {
+        check_record(&recording->records[PASCO2_I2C_RECORD_PROLOGUE + ((i - PASCO2_I2C_RECORD_PROLOGUE) % ring)],
+                     &model.log[i]);
+    }
+
+    /* An explicit freeze does not replace the error */
+    host_uart_clear();
+    pasco2_i2c_record_dump();
+    HOST_CHECK(recording->trigger == COMMUNICATION_ERROR_RESULT);
+    check_dump(host_uart_output);
+    printf("%u transfers on the bus, %u recorded, %u stored\n",
+           (unsigned int)model.transfers,
+           (unsigned int)recording->count,
+           PASCO2_I2C_RECORD_TRANSFERS);
+
+    if (argc > 1)
+    {
+        FILE *file = fopen(argv[1], "w");
+        HOST_CHECK(file != NULL);
+        HOST_CHECK(fwrite(host_uart_output, 1U, host_uart_length, file) == host_uart_length);
+        fclose(file);
+    }
+    return EXIT_SUCCESS;
+}
+
+#elif defined(PASCO2_I2C_REPLAY_ENABLED)
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the driver model against the replayed session until the
+ *   communication error is reported.
+ *******************************************************************************/
+int main(void)
+{
+    uint16_t ppm = 0;
+    uint16_t last_ppm = 0;
+    uint32_t measurements = 0;
+    uint32_t status;
+
+    driver_init();
+    do
+    {
+        HOST_CHECK(measurements < ERROR_MEASUREMENT);
+        host_time_ms += MEASUREMENT_PERIOD;
+        measurements++;
+        status = driver_get_ppm(&ppm);
+        if (status == DRIVER_PPM_READY)
+        {
+            last_ppm = ppm;
+        }
+    } while (status != DRIVER_COMMUNICATION_ERROR);
+
+    /* The values before the error are the recorded ones, and the whole
+     * session was replayed on time */
+    printf("%s", host_uart_output);
+    HOST_CHECK(last_ppm == MODEL_PPM(ERROR_MEASUREMENT - 1U));
+    HOST_CHECK(strstr(host_uart_output, "I2C replay completed") != NULL);
+    HOST_CHECK(strstr(host_uart_output, " 0 late") != NULL);
+    return EXIT_SUCCESS;
+}
+
+#endif /* defined(PASCO2_I2C_RECORD_ENABLED) */
@@ -0,0 +1,324 @@
+/*****************************************************************************
+** File name: test_pool.c
+**
+** Description: Host test of the fixed-block pool allocator. It checks the
+** statistics and exhaustion handling, and runs a concurrent stress benchmark
+** in which several threads allocate, fill, verify and free blocks of a small
+** pool. The same load is timed with malloc and free for comparison. A long
+** single threaded run allocates and frees blocks in random order and checks
+** that the pool only fails when all blocks are in use; the heap used by
+** malloc for the same sequence is reported next to the pool storage.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <malloc.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_pool.h"
+
+/* Block size and count of the stressed pool, like the sensor messages */
+#define STRESS_BLOCK_SIZE  (16U)
+#define STRESS_BLOCK_COUNT (4U)
+/* Number of concurrent threads and operations per thread */
+#define STRESS_THREADS    (4U)
+#define STRESS_ITERATIONS (200000U)
+/* Block count of the fragmentation run, its operations and the number of
+ * operations after which the allocation probability changes */
+#define FRAGMENT_BLOCK_COUNT (32U)
+#define FRAGMENT_OPERATIONS  (1000000U)
+#define FRAGMENT_PHASE       (5000U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    uint8_t id;
+    bool use_malloc;
+    uint32_t allocated;
+    uint32_t corrupted;
+} stress_thread_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+PASCO2_POOL_DEFINE(small_pool, 10U, 3U);
+PASCO2_POOL_DEFINE(stress_pool, STRESS_BLOCK_SIZE, STRESS_BLOCK_COUNT);
+PASCO2_POOL_DEFINE(fragment_pool, STRESS_BLOCK_SIZE, FRAGMENT_BLOCK_COUNT);
+
+/*******************************************************************************
+ * Function Name: test_statistics
+ *******************************************************************************
+ * Summary:
+ *   Exhausts a pool and checks blocks, statistics and reuse.
+ *******************************************************************************/
+static void test_statistics(void)
+{
+    void *blocks[3];
+
+    pasco2_pool_init(&small_pool);
+    HOST_CHECK(small_pool.block_size == 12U);
+
+    for (uint32_t i = 0; i < 3U; i++)
+    {
+        blocks[i] = pasco2_pool_alloc(&small_pool);
+        HOST_CHECK(blocks[i] != NULL);
+        HOST_CHECK(((uintptr_t)blocks[i] % 4U) == 0U);
+        memset(blocks[i], (int)i, small_pool.block_size);
+    }
+    HOST_CHECK(pasco2_pool_alloc(&small_pool) == NULL);
+    HOST_CHECK(small_pool.used == 3U);
+    HOST_CHECK(small_pool.high_water == 3U);
+    HOST_CHECK(small_pool.allocations == 3U);
+    HOST_CHECK(small_pool.failures == 1U);
+
+    /* Blocks do not overlap */
+    for (uint32_t i = 0; i < 3U; i++)
+    {
+        for (uint32_t j = 0; j < small_pool.block_size; j++)
+        {
+            HOST_CHECK(((uint8_t *)blocks[i])[j] == i);
+        }
+    }
+
+    /* The block freed last is reused first */
+    pasco2_pool_free(&small_pool, blocks[1]);
+    pasco2_pool_free(&small_pool, NULL);
+    HOST_CHECK(small_pool.used == 2U);
+    HOST_CHECK(pasco2_pool_alloc(&small_pool) == blocks[1]);
+    pasco2_pool_free(&small_pool, blocks[0]);
+    pasco2_pool_free(&small_pool, blocks[1]);
+    pasco2_pool_free(&small_pool, blocks[2]);
+    HOST_CHECK(small_pool.used == 0U);
+    HOST_CHECK(small_pool.high_water == 3U);
+}
+
+/*******************************************************************************
+ * Function Name: stress_thread
+ *******************************************************************************
+ * Summary:
+ *   Allocates a block, fills it with the thread id, yields the block to the
+ *   other threads for a moment, verifies it and frees it.
+ *******************************************************************************/
+static void *stress_thread(void *arg)
+{
+    stress_thread_t *thread = arg;
+
+    for (uint32_t i = 0; i < STRESS_ITERATIONS; i++)
+    {
+        uint8_t *block =
+            thread->use_malloc ? malloc(STRESS_BLOCK_SIZE) : (uint8_t *)pasco2_pool_alloc(&stress_pool);
+        if (block == NULL)
+        {
+            continue;
+        }
+        thread->allocated++;
+        memset(block, thread->id, STRESS_BLOCK_SIZE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        for (uint32_t j = 0; j < STRESS_BLOCK_SIZE; j++)
+        {
+            if (((volatile uint8_t *)block)[j] != thread->id)
+            {
+                thread->corrupted++;
+                break;
+            }
+        }
+        if (thread->use_malloc)
+        {
+            free(block);
+        }
+        else
+        {
+            pasco2_pool_free(&stress_pool, block);
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: stress_run
+ *******************************************************************************
+ * Summary:
+ *   Runs the stress threads and returns the time per allocation and free in
+ *   ns.
+ *******************************************************************************/
+static double stress_run(bool use_malloc, uint32_t *allocated)
+{
+    pthread_t threads[STRESS_THREADS];
+    stress_thread_t state[STRESS_THREADS];
+    struct timespec start;
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < STRESS_THREADS; i++)
+    {
+        state[i] = (stress_thread_t){.id = (uint8_t)(i + 1U), .use_malloc = use_malloc};
+        HOST_CHECK(pthread_create(&threads[i], NULL, stress_thread, &state[i]) == 0);
+    }
+    *allocated = 0;
+    for (uint32_t i = 0; i < STRESS_THREADS; i++)
+    {
+        HOST_CHECK(pthread_join(threads[i], NULL) == 0);
+        HOST_CHECK(state[i].corrupted == 0U);
+        *allocated += state[i].allocated;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed_ns = ((double)(end.tv_sec - start.tv_sec) * 1e9) + (double)(end.tv_nsec - start.tv_nsec);
+    return elapsed_ns / (STRESS_THREADS * STRESS_ITERATIONS);
+}
+
+/*******************************************************************************
+ * Function Name: fragment_run
+ *******************************************************************************
+ * Summary:
+ *   Allocates and frees blocks in a random but repeatable order. The
+ *   allocation probability alternates between 70% and 30%, so the number of
+ *   blocks in use sweeps between none and all of them. Each block is filled
+ *   with a tag which is verified when a randomly chosen block is freed. The
+ *   pool has to deliver a block whenever one is free; malloc is not called
+ *   with all blocks in use, so it sees the same sequence. Returns the peak
+ *   number of heap bytes malloc has in use for the blocks, including its
+ *   chunk headers.
+ *******************************************************************************/
+static void fragment_run(bool use_malloc, size_t *peak_in_use)
+{
+    uint8_t *live[FRAGMENT_BLOCK_COUNT];
+    uint8_t tags[FRAGMENT_BLOCK_COUNT];
+    uint32_t live_count = 0;
+    uint32_t random = 1U;
+    struct mallinfo2 base = mallinfo2();
+
+    *peak_in_use = 0;
+    for (uint32_t i = 0; i < FRAGMENT_OPERATIONS; i++)
+    {
+        random = (random * 1103515245U) + 12345U;
+        uint32_t alloc_percent = (((i / FRAGMENT_PHASE) % 2U) == 0U) ? 70U : 30U;
+        if ((live_count == 0U) || (((random >> 16) % 100U) < alloc_percent))
+        {
+            if (use_malloc && (live_count == FRAGMENT_BLOCK_COUNT))
+            {
+                continue;
+            }
+            uint8_t *block = use_malloc ? malloc(STRESS_BLOCK_SIZE) : pasco2_pool_alloc(&fragment_pool);
+            if (live_count == FRAGMENT_BLOCK_COUNT)
+            {
+                HOST_CHECK(block == NULL);
+                continue;
+            }
+            HOST_CHECK(block != NULL);
+            tags[live_count] = (uint8_t)i;
+            memset(block, tags[live_count], STRESS_BLOCK_SIZE);
+            live[live_count++] = block;
+        }
+        else
+        {
+            uint32_t index = (random >> 8) % live_count;
+            for (uint32_t j = 0; j < STRESS_BLOCK_SIZE; j++)
+            {
+                HOST_CHECK(live[index][j] == tags[index]);
+            }
+            if (use_malloc)
+            {
+                free(live[index]);
+            }
+            else
+            {
+                pasco2_pool_free(&fragment_pool, live[index]);
+            }
+            live_count--;
+            live[index] = live[live_count];
+            tags[index] = tags[live_count];
+        }
+
+        if (use_malloc)
+        {
+            struct mallinfo2 info = mallinfo2();
+            size_t in_use = (info.uordblks > base.uordblks) ? (info.uordblks - base.uordblks) : 0U;
+            *peak_in_use = (in_use > *peak_in_use) ? in_use : *peak_in_use;
+        }
+    }
+
+    while (live_count > 0U)
+    {
+        live_count--;
+        if (use_malloc)
+        {
+            free(live[live_count]);
+        }
+        else
+        {
+            pasco2_pool_free(&fragment_pool, live[live_count]);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    test_statistics();
+
+    pasco2_pool_init(&stress_pool);
+    uint32_t pool_allocated;
+    uint32_t malloc_allocated;
+    double pool_ns = stress_run(false, &pool_allocated);
+    double malloc_ns = stress_run(true, &malloc_allocated);
+
+    /* Every block has been returned and every attempt is accounted for */
+    HOST_CHECK(stress_pool.used == 0U);
+    HOST_CHECK(stress_pool.allocations == pool_allocated);
+    HOST_CHECK((stress_pool.allocations + stress_pool.failures) == (STRESS_THREADS * STRESS_ITERATIONS));
+    HOST_CHECK(stress_pool.high_water <= STRESS_BLOCK_COUNT);
+    HOST_CHECK(malloc_allocated == (STRESS_THREADS * STRESS_ITERATIONS));
+
+    printf("%u threads, %u blocks of %u bytes\n", STRESS_THREADS, STRESS_BLOCK_COUNT, STRESS_BLOCK_SIZE);
+    printf("pool:   %6.1f ns per allocation and free, %u failures, peak %u blocks\n",
+           pool_ns,
+           (unsigned int)stress_pool.failures,
+           (unsigned int)stress_pool.high_water);
+    printf("malloc: %6.1f ns per allocation and free\n", malloc_ns);
+
+    /* Every failure of the long run happened with all blocks in use */
+    size_t peak_in_use;
+    pasco2_pool_init(&fragment_pool);
+    fragment_run(false, &peak_in_use);
+    HOST_CHECK(fragment_pool.used == 0U);
+    HOST_CHECK(fragment_pool.high_water == FRAGMENT_BLOCK_COUNT);
+    HOST_CHECK(fragment_pool.failures > 0U);
+    fragment_run(true, &peak_in_use);
+    printf("%u random allocations and frees, up to %u blocks of %u bytes\n",
+           FRAGMENT_OPERATIONS,
+           FRAGMENT_BLOCK_COUNT,
+           STRESS_BLOCK_SIZE);
+    printf("pool:   %u bytes of storage, %u allocations, %u failures with all blocks in use\n",
+           (unsigned int)sizeof(fragment_pool_storage),
+           (unsigned int)fragment_pool.allocations,
+           (unsigned int)fragment_pool.failures);
+    printf("malloc: peak %zu bytes of heap in use\n", peak_in_use);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,302 @@
+/*****************************************************************************
+** File name: test_print.c
+**
+** Description: Host test of the terminal output formatter. It compares the
+** output with the C library for the supported conversions, checks that the
+** output stops at unsupported ones, checks the line ending conversion and
+** measures the stack used by pasco2_printf and by the C library vsnprintf
+** with a painted thread stack, and the time both take for the same lines.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file includes */
+#include "cy_retarget_io.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_print.h"
+
+/* Size of the painted thread stack */
+#define STACK_SIZE (256U * 1024U)
+/* Fill pattern of the painted thread stack */
+#define STACK_PATTERN (0xA5U)
+/* Number of timed runs of the terminal lines */
+#define TIMING_REPETITIONS (100000U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+static uint8_t stack_area[STACK_SIZE] __attribute__((aligned(4096)));
+
+/*******************************************************************************
+ * Function Name: check_format
+ *******************************************************************************
+ * Summary:
+ *   Formats the arguments with pasco2_vprintf and vsnprintf and checks that
+ *   the output and the returned length match. '\n' in the reference output
+ *   is expected as "\r\n" like on the target.
+ *******************************************************************************/
+static void __attribute__((format(printf, 1, 2))) check_format(const char *format, ...)
+{
+    char expected[256];
+    char converted[512];
+    va_list args;
+    va_list copy;
+
+    va_start(args, format);
+    va_copy(copy, args);
+    (void)vsnprintf(expected, sizeof(expected), format, copy);
+    va_end(copy);
+    host_uart_clear();
+    int count = pasco2_vprintf(format, args);
+    va_end(args);
+
+    size_t length = 0;
+    for (const char *c = expected; *c != '\0'; c++)
+    {
+        if (*c == '\n')
+        {
+            converted[length++] = '\r';
+        }
+        converted[length++] = *c;
+    }
+    converted[length] = '\0';
+
+    if (strcmp(host_uart_output, converted) != 0)
+    {
+        fprintf(stderr, "format \"%s\": got \"%s\", expected \"%s\"\n", format, host_uart_output, converted);
+    }
+    HOST_CHECK(strcmp(host_uart_output, converted) == 0);
+    HOST_CHECK(count == (int)strlen(expected));
+}
+
+/*******************************************************************************
+ * Function Name: print_unchecked
+ *******************************************************************************
+ * Summary:
+ *   Calls pasco2_vprintf without the format check of the compiler, for the
+ *   formats that pasco2_vprintf does not support.
+ *******************************************************************************/
+static int print_unchecked(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    host_uart_clear();
+    int count = pasco2_vprintf(format, args);
+    va_end(args);
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: print_terminal_lines
+ *******************************************************************************
+ * Summary:
+ *   Prints the lines the application prints most often with pasco2_printf.
+ *******************************************************************************/
+static void *print_terminal_lines(void *arg)
+{
+    pasco2_printf("CO2 PPM Level: %d\r\n", 812);
+    pasco2_printf("%-12s %8u %8u %8u\r\n", "CO2 sensor", 1234U, 42U, 0U);
+    pasco2_printf("%02x", 0xA5U);
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: libc_printf
+ *******************************************************************************
+ * Summary:
+ *   Formats with the C library without an output buffer, so that only the
+ *   formatter itself uses stack. The va_list keeps the compiler from
+ *   evaluating the call at compile time.
+ *******************************************************************************/
+static int __attribute__((format(printf, 1, 2))) libc_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int count = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: vsnprintf_terminal_lines
+ *******************************************************************************
+ * Summary:
+ *   Formats the same lines with the C library.
+ *******************************************************************************/
+static void *vsnprintf_terminal_lines(void *arg)
+{
+    (void)libc_printf("CO2 PPM Level: %d\r\n", 812);
+    (void)libc_printf("%-12s %8u %8u %8u\r\n", "CO2 sensor", 1234U, 42U, 0U);
+    (void)libc_printf("%02x", 0xA5U);
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: libc_uart_printf
+ *******************************************************************************
+ * Summary:
+ *   Formats with the C library into a buffer and writes the characters to
+ *   the debug UART, like printf through retarget-io.
+ *******************************************************************************/
+static int __attribute__((format(printf, 1, 2))) libc_uart_printf(const char *format, ...)
+{
+    char buffer[128];
+    va_list args;
+    va_start(args, format);
+    int count = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    for (int i = 0; i < count; i++)
+    {
+        (void)cyhal_uart_putc(&cy_retarget_io_uart_obj, (uint32_t)buffer[i]);
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: uart_terminal_lines
+ *******************************************************************************
+ * Summary:
+ *   Prints the terminal lines through the C library.
+ *******************************************************************************/
+static void *uart_terminal_lines(void *arg)
+{
+    (void)libc_uart_printf("CO2 PPM Level: %d\r\n", 812);
+    (void)libc_uart_printf("%-12s %8u %8u %8u\r\n", "CO2 sensor", 1234U, 42U, 0U);
+    (void)libc_uart_printf("%02x", 0xA5U);
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: time_per_run
+ *******************************************************************************
+ * Summary:
+ *   Returns the mean time in ns of a run of the function. The captured UART
+ *   output is discarded before every run.
+ *******************************************************************************/
+static double time_per_run(void *(*function)(void *))
+{
+    struct timespec start;
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < TIMING_REPETITIONS; i++)
+    {
+        host_uart_clear();
+        (void)function(NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (((double)(end.tv_sec - start.tv_sec) * 1e9) + (double)(end.tv_nsec - start.tv_nsec)) /
+           TIMING_REPETITIONS;
+}
+
+/*******************************************************************************
+ * Function Name: idle
+ *******************************************************************************
+ * Summary:
+ *   Empty thread function, measures the stack used by the thread start.
+ *******************************************************************************/
+static void *idle(void *arg)
+{
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: stack_usage
+ *******************************************************************************
+ * Summary:
+ *   Runs a function on a thread with a painted stack and returns the number
+ *   of bytes of the stack which have been overwritten.
+ *******************************************************************************/
+static size_t stack_usage(void *(*function)(void *))
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    memset(stack_area, STACK_PATTERN, sizeof(stack_area));
+    HOST_CHECK(pthread_attr_init(&attr) == 0);
+    HOST_CHECK(pthread_attr_setstack(&attr, stack_area, sizeof(stack_area)) == 0);
+    HOST_CHECK(pthread_create(&thread, &attr, function, NULL) == 0);
+    HOST_CHECK(pthread_join(thread, NULL) == 0);
+    pthread_attr_destroy(&attr);
+
+    /* The stack grows down, the lowest overwritten byte marks the peak */
+    size_t unused = 0;
+    while ((unused < sizeof(stack_area)) && (stack_area[unused] == STACK_PATTERN))
+    {
+        unused++;
+    }
+    return sizeof(stack_area) - unused;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    check_format("CO2 PPM Level: %d\n", 812);
+    check_format("%d %i %d", 0, -1, INT32_MIN);
+    check_format("%u %u", 0U, UINT32_MAX);
+    check_format("%x %X %08x %02x", 0xDEADBEEFU, 0xCAFEU, 0x12U, 0x5U);
+    check_format("[%5d] [%-5d] [%05d] [%-3u]", 42, 42, -42, 7U);
+    check_format("[%c] [%3c] [%-3c]", 'a', 'b', 'c');
+    check_format("[%s] [%8s] [%-8s]", "log", "CO2", "LED");
+    check_format("%hu %hhu %lu %ld", (unsigned short)65535U, (unsigned char)255U, 123456UL, -123456L);
+    check_format("100%%\n\n");
+
+    /* Floating point, pointer and precision conversions are not supported:
+     * the output stops before them and the characters up to there are
+     * counted */
+    HOST_CHECK(print_unchecked("T: %f C, %d ppm", 21.5, 812) == 3);
+    HOST_CHECK(strcmp(host_uart_output, "T: ") == 0);
+    HOST_CHECK(print_unchecked("%d %p", 1, (void *)host_uart_output) == 2);
+    HOST_CHECK(strcmp(host_uart_output, "1 ") == 0);
+    HOST_CHECK(print_unchecked("[%.2s]", "abc") == 1);
+    HOST_CHECK(strcmp(host_uart_output, "[") == 0);
+    HOST_CHECK(print_unchecked("end %") == 4);
+    HOST_CHECK(strcmp(host_uart_output, "end ") == 0);
+
+    /* Every line feed is preceded by a carriage return */
+    host_uart_clear();
+    pasco2_printf("a\nb\r\n");
+    HOST_CHECK(strcmp(host_uart_output, "a\r\nb\r\r\n") == 0);
+
+    size_t base = stack_usage(idle);
+    size_t pasco2 = stack_usage(print_terminal_lines) - base;
+    size_t libc = stack_usage(vsnprintf_terminal_lines) - base;
+    printf("Stack used for the terminal lines: pasco2_printf %zu bytes, C library vsnprintf %zu bytes\n",
+           pasco2,
+           libc);
+
+    HOST_CHECK(pasco2 < 512U);
+    HOST_CHECK(pasco2 < libc);
+
+    /* Both write every character to the UART, the C library formats into a
+     * buffer first */
+    double pasco2_ns = time_per_run(print_terminal_lines);
+    double libc_ns = time_per_run(uart_terminal_lines);
+    printf("Time for the terminal lines: pasco2_printf %.1f ns, C library vsnprintf %.1f ns\n", pasco2_ns, libc_ns);
+    return EXIT_SUCCESS;
+}
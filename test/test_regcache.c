@@ -0,0 +1,357 @@
+/*****************************************************************************
+** File name: test_regcache.c
+**
+** Description: Host test of the register cache. The wrapped HAL functions
+** talk to a register model of the PAS CO2 sensor with an auto-incrementing
+** address pointer and injectable NAKs. The test checks the counters, the
+** cached values against the model and that failed transfers reach the caller.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_regcache.h"
+
+/* Result of a transfer which the model does not acknowledge */
+#define MODEL_NAK (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, 0x01U, 0x01U))
+/* Product ID of the model */
+#define MODEL_PROD_ID (0x42U)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Register model of the sensor */
+static struct
+{
+    uint8_t regs[PASCO2_REG_COUNT];
+    uint8_t pointer;
+    uint32_t transfers;
+    uint32_t naks; /* number of following transfers which are not acknowledged */
+} model;
+
+/*******************************************************************************
+ * Function Name: model_transfer
+ *******************************************************************************
+ * Summary:
+ *   Counts a transfer and returns whether the model acknowledges it.
+ *******************************************************************************/
+static bool model_transfer(uint16_t address)
+{
+    model.transfers++;
+    if (model.naks > 0U)
+    {
+        model.naks--;
+        return false;
+    }
+    return address == PASCO2_REGCACHE_I2C_ADDRESS;
+}
+
+/*******************************************************************************
+ * Function Name: model_write
+ *******************************************************************************
+ * Summary:
+ *   Writes registers from the address pointer on. A write to SENS_RST resets
+ *   the register map.
+ *******************************************************************************/
+static void model_write(const uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++)
+    {
+        if (model.pointer == PASCO2_REG_SENS_RST)
+        {
+            memset(model.regs, 0, sizeof(model.regs));
+            model.regs[PASCO2_REG_PROD_ID] = MODEL_PROD_ID;
+        }
+        else if (model.pointer < PASCO2_REG_COUNT)
+        {
+            model.regs[model.pointer] = data[i];
+        }
+        model.pointer++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: model_read
+ *******************************************************************************
+ * Summary:
+ *   Reads registers from the address pointer on.
+ *******************************************************************************/
+static void model_read(uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++)
+    {
+        data[i] = (model.pointer < PASCO2_REG_COUNT) ? model.regs[model.pointer] : 0U;
+        model.pointer++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_write
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    if (!model_transfer(dev_addr))
+    {
+        return MODEL_NAK;
+    }
+    model.pointer = data[0];
+    model_write(&data[1], size - 1U);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    if (!model_transfer(dev_addr))
+    {
+        return MODEL_NAK;
+    }
+    model_read(data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_write
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout)
+{
+    if (!model_transfer(address))
+    {
+        return MODEL_NAK;
+    }
+    model.pointer = (uint8_t)mem_addr;
+    model_write(data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout)
+{
+    if (!model_transfer(address))
+    {
+        return MODEL_NAK;
+    }
+    model.pointer = (uint8_t)mem_addr;
+    model_read(data, size);
+    return CY_RSLT_SUCCESS;
+}
+
+/* The application calls the HAL functions, the linker redirects them to the
+ * wrappers of the cache */
+cy_rslt_t __wrap_cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t __wrap_cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop);
+cy_rslt_t __wrap_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout);
+cy_rslt_t __wrap_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout);
+
+/*******************************************************************************
+ * Function Name: read_reg
+ *******************************************************************************
+ * Summary:
+ *   Reads registers like the driver with an address write and a read.
+ *******************************************************************************/
+static cy_rslt_t read_reg(uint8_t reg, uint8_t *data, uint16_t size)
+{
+    cy_rslt_t result = __wrap_cyhal_i2c_master_write(NULL, PASCO2_REGCACHE_I2C_ADDRESS, &reg, 1U, 0U, false);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = __wrap_cyhal_i2c_master_read(NULL, PASCO2_REGCACHE_I2C_ADDRESS, data, size, 0U, true);
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: write_reg
+ *******************************************************************************
+ * Summary:
+ *   Writes registers like the driver with a single write.
+ *******************************************************************************/
+static cy_rslt_t write_reg(uint8_t reg, const uint8_t *data, uint16_t size)
+{
+    uint8_t buffer[PASCO2_REG_COUNT + 1U];
+    buffer[0] = reg;
+    memcpy(&buffer[1], data, size);
+    return __wrap_cyhal_i2c_master_write(NULL, PASCO2_REGCACHE_I2C_ADDRESS, buffer, size + 1U, 0U, true);
+}
+
+/*******************************************************************************
+ * Function Name: check_statistics
+ *******************************************************************************
+ * Summary:
+ *   Checks the counters of the cache, the bus transfers have to match the
+ *   transfers seen by the model.
+ *******************************************************************************/
+static void check_statistics(uint32_t hits, uint32_t misses, uint32_t skipped, uint32_t invalidations)
+{
+    pasco2_regcache_statistics_t statistics;
+    pasco2_regcache_get_statistics(&statistics);
+    HOST_CHECK(statistics.bus_transactions == model.transfers);
+    HOST_CHECK(statistics.read_hits == hits);
+    HOST_CHECK(statistics.read_misses == misses);
+    HOST_CHECK(statistics.writes_skipped == skipped);
+    HOST_CHECK(statistics.invalidations == invalidations);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    uint8_t value[2];
+    const uint8_t period[2] = {0x00U, 0x3CU};
+    const uint8_t pressure[2] = {0x03U, 0xF5U};
+
+    model.regs[PASCO2_REG_PROD_ID] = MODEL_PROD_ID;
+
+    /* The product ID is not cached: every read reaches the sensor */
+    for (uint32_t i = 0; i < 3U; i++)
+    {
+        HOST_CHECK(read_reg(PASCO2_REG_PROD_ID, value, 1U) == CY_RSLT_SUCCESS);
+        HOST_CHECK(value[0] == MODEL_PROD_ID);
+    }
+    HOST_CHECK(model.transfers == 6U);
+    check_statistics(0U, 0U, 0U, 0U);
+
+    /* A lost sensor is reported even for a cached register: the address
+     * write is not deferred */
+    HOST_CHECK(write_reg(PASCO2_REG_MEAS_RATE_H, period, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_H, value, 2U) == CY_RSLT_SUCCESS);
+    check_statistics(1U, 0U, 0U, 0U);
+    model.naks = 1U;
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_H, value, 2U) == MODEL_NAK);
+    check_statistics(1U, 0U, 0U, 1U);
+
+    /* After the failure the first read is a miss and fills the cache, the
+     * following reads only send the address */
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_H, value, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK(memcmp(value, period, 2U) == 0);
+    uint32_t transfers = model.transfers;
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_H, value, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK(memcmp(value, period, 2U) == 0);
+    HOST_CHECK(model.transfers == (transfers + 1U));
+    check_statistics(2U, 1U, 0U, 1U);
+
+    /* Status and result registers are always read from the sensor */
+    model.regs[PASCO2_REG_CO2PPM_H] = 0x03U;
+    model.regs[PASCO2_REG_CO2PPM_L] = 0x2CU;
+    HOST_CHECK(read_reg(PASCO2_REG_CO2PPM_H, value, 2U) == CY_RSLT_SUCCESS);
+    model.regs[PASCO2_REG_CO2PPM_L] = 0x2DU;
+    HOST_CHECK(read_reg(PASCO2_REG_CO2PPM_H, value, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK(value[1] == 0x2DU);
+    check_statistics(2U, 1U, 0U, 1U);
+
+    /* A read spanning cached and uncached registers goes to the bus */
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_L, value, 2U) == CY_RSLT_SUCCESS);
+    check_statistics(2U, 2U, 0U, 1U);
+
+    /* Unchanged writes are skipped, changed ones reach the sensor and the
+     * cache, with both transfer styles of the HAL */
+    HOST_CHECK(write_reg(PASCO2_REG_MEAS_RATE_H, period, 2U) == CY_RSLT_SUCCESS);
+    check_statistics(2U, 2U, 1U, 1U);
+    HOST_CHECK(__wrap_cyhal_i2c_master_mem_write(
+                   NULL, PASCO2_REGCACHE_I2C_ADDRESS, PASCO2_REG_PRESS_REF_H, 1U, pressure, 2U, 0U) ==
+               CY_RSLT_SUCCESS);
+    HOST_CHECK(memcmp(&model.regs[PASCO2_REG_PRESS_REF_H], pressure, 2U) == 0);
+    HOST_CHECK(__wrap_cyhal_i2c_master_mem_read(
+                   NULL, PASCO2_REGCACHE_I2C_ADDRESS, PASCO2_REG_PRESS_REF_H, 1U, value, 2U, 0U) == CY_RSLT_SUCCESS);
+    HOST_CHECK(memcmp(value, pressure, 2U) == 0);
+    HOST_CHECK(__wrap_cyhal_i2c_master_mem_write(
+                   NULL, PASCO2_REGCACHE_I2C_ADDRESS, PASCO2_REG_PRESS_REF_H, 1U, pressure, 2U, 0U) ==
+               CY_RSLT_SUCCESS);
+    check_statistics(3U, 2U, 2U, 1U);
+
+    /* A failed write does not update the cache */
+    const uint8_t threshold[2] = {0x01U, 0xF4U};
+    model.naks = 1U;
+    HOST_CHECK(write_reg(PASCO2_REG_ALARM_TH_H, threshold, 2U) == MODEL_NAK);
+    HOST_CHECK(model.regs[PASCO2_REG_ALARM_TH_H] == 0U);
+    HOST_CHECK(read_reg(PASCO2_REG_ALARM_TH_H, value, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK((value[0] == 0U) && (value[1] == 0U));
+    check_statistics(3U, 3U, 2U, 2U);
+
+    /* A soft reset drops the cache, the next read sees the reset values */
+    const uint8_t reset = 0xA3U;
+    HOST_CHECK(write_reg(PASCO2_REG_SENS_RST, &reset, 1U) == CY_RSLT_SUCCESS);
+    check_statistics(3U, 3U, 2U, 3U);
+    HOST_CHECK(read_reg(PASCO2_REG_MEAS_RATE_H, value, 2U) == CY_RSLT_SUCCESS);
+    HOST_CHECK((value[0] == 0U) && (value[1] == 0U));
+    check_statistics(3U, 4U, 2U, 3U);
+
+    /* A read without a preceding address write continues at an unknown
+     * pointer and is not served from the cache */
+    transfers = model.transfers;
+    HOST_CHECK(__wrap_cyhal_i2c_master_read(NULL, PASCO2_REGCACHE_I2C_ADDRESS, value, 2U, 0U, true) ==
+               CY_RSLT_SUCCESS);
+    HOST_CHECK(model.transfers == (transfers + 1U));
+    check_statistics(3U, 4U, 2U, 3U);
+
+    /* Every cached value matches the sensor */
+    for (uint8_t reg = 0; reg < PASCO2_REG_SENS_RST; reg++)
+    {
+        HOST_CHECK(read_reg(reg, value, 1U) == CY_RSLT_SUCCESS);
+        HOST_CHECK(value[0] == model.regs[reg]);
+    }
+
+    /* Other devices on the bus are passed through */
+    transfers = model.transfers;
+    HOST_CHECK(__wrap_cyhal_i2c_master_read(NULL, 0x50U, value, 1U, 0U, true) == MODEL_NAK);
+    HOST_CHECK(model.transfers == (transfers + 1U));
+
+    pasco2_regcache_print_statistics();
+    printf("%s", host_uart_output);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+/*****************************************************************************
+** File name: test_rollup.c
+**
+** Description: Host test and benchmark of the CO2 history rollups. A week of
+** synthetic samples, one every 10 s, is added to the tables. The answers of
+** range queries are compared with a scan of the raw samples over the same
+** buckets, and the latency of both is measured.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+#include <time.h>
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_rollup.h"
+
+/* Sample period in ms and number of samples in a week */
+#define SAMPLE_PERIOD (10000U)
+#define SAMPLE_COUNT  ((7U * 86400U) / (SAMPLE_PERIOD / 1000U))
+/* Number of timed calls per query */
+#define QUERY_REPETITIONS (20000U)
+#define SCAN_REPETITIONS  (20U)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint32_t range;      /* in s */
+    uint32_t resolution; /* bucket length in s of the table which answers */
+} query_t;
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Raw samples and their time since boot in s */
+static uint16_t sample_ppm[SAMPLE_COUNT];
+static uint32_t sample_time[SAMPLE_COUNT];
+
+static const query_t queries[] = {
+    {"30m", 30U * 60U, 60U},
+    {"2h", 2U * 3600U, 60U},
+    {"24h", 24U * 3600U, 3600U},
+    {"48h", 48U * 3600U, 3600U},
+    {"7d", 7U * 86400U, 86400U},
+    {"31d", 31U * 86400U, 86400U},
+};
+
+/*******************************************************************************
+ * Function Name: synthetic_ppm
+ *******************************************************************************
+ * Summary:
+ *   Returns an office-like CO2 value: outdoor level at night, occupancy
+ *   during working hours on weekdays, and a small deterministic noise.
+ *******************************************************************************/
+static uint16_t synthetic_ppm(uint32_t time_s, uint32_t *noise)
+{
+    uint32_t day = time_s / 86400U;
+    uint32_t hour = (time_s % 86400U) / 3600U;
+    *noise = (*noise * 1103515245U) + 12345U;
+    uint32_t ppm = 420U + ((*noise >> 16) % 20U);
+    /* The week starts on a Saturday */
+    if (((day % 7U) >= 2U) && (hour >= 8U) && (hour < 18U))
+    {
+        ppm += 300U + ((hour - 8U) * 60U);
+    }
+    return (uint16_t)ppm;
+}
+
+/*******************************************************************************
+ * Function Name: table_size
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of buckets of the table with the given resolution.
+ *******************************************************************************/
+static uint32_t table_size(uint32_t resolution)
+{
+    if (resolution == 60U)
+    {
+        return PASCO2_ROLLUP_MINUTES;
+    }
+    HOST_CHECK((resolution == 3600U) || (resolution == 86400U));
+    return (resolution == 3600U) ? PASCO2_ROLLUP_HOURS : PASCO2_ROLLUP_DAYS;
+}
+
+/*******************************************************************************
+ * Function Name: scan
+ *******************************************************************************
+ * Summary:
+ *   Aggregates the raw samples from the given time on, as done without the
+ *   rollups.
+ *******************************************************************************/
+static void scan(uint32_t start_s, pasco2_rollup_result_t *result)
+{
+    uint64_t sum = 0;
+    *result = (pasco2_rollup_result_t){.min = UINT16_MAX};
+    for (uint32_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        if (sample_time[i] < start_s)
+        {
+            continue;
+        }
+        sum += sample_ppm[i];
+        result->count++;
+        result->min = (sample_ppm[i] < result->min) ? sample_ppm[i] : result->min;
+        result->max = (sample_ppm[i] > result->max) ? sample_ppm[i] : result->max;
+    }
+    result->mean = (uint16_t)((sum + (result->count / 2U)) / result->count);
+}
+
+/*******************************************************************************
+ * Function Name: elapsed_ns
+ *******************************************************************************/
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    struct timespec start;
+    struct timespec end;
+    pasco2_rollup_result_t result;
+
+    /* No samples yet */
+    HOST_CHECK(!pasco2_rollup_query(3600U, &result));
+    HOST_CHECK(result.count == 0U);
+
+    /* A week of samples */
+    uint32_t noise = 1U;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < SAMPLE_COUNT; i++)
+    {
+        host_time_ms += SAMPLE_PERIOD;
+        sample_time[i] = host_time_ms / 1000U;
+        sample_ppm[i] = synthetic_ppm(sample_time[i], &noise);
+        pasco2_rollup_add(sample_ppm[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double add_ns = elapsed_ns(&start, &end) / SAMPLE_COUNT;
+    uint32_t now = host_time_ms / 1000U;
+
+    printf("%u samples over 7 days, %.1f ns per sample added\n", SAMPLE_COUNT, add_ns);
+    printf("%-6s %-10s %8s %8s %6s %6s %6s %12s %12s\n",
+           "Range",
+           "Resolution",
+           "Buckets",
+           "Samples",
+           "Min",
+           "Max",
+           "Mean",
+           "Rollup ns",
+           "Scan ns");
+    for (uint32_t q = 0; q < (sizeof(queries) / sizeof(queries[0])); q++)
+    {
+        HOST_CHECK(pasco2_rollup_query(queries[q].range, &result));
+        HOST_CHECK(result.resolution == queries[q].resolution);
+        HOST_CHECK(result.buckets <= PASCO2_ROLLUP_MINUTES);
+
+        /* The query covers whole buckets: from the bucket of the range start,
+         * or the oldest bucket of the table if the range is longer */
+        uint32_t first = (queries[q].range < now) ? ((now - queries[q].range) / result.resolution) : 0U;
+        uint32_t last = now / result.resolution;
+        if ((last - first) >= table_size(result.resolution))
+        {
+            first = last - (table_size(result.resolution) - 1U);
+        }
+        HOST_CHECK(result.buckets == ((last - first) + 1U));
+        pasco2_rollup_result_t expected;
+        scan(first * result.resolution, &expected);
+        HOST_CHECK(result.count == expected.count);
+        HOST_CHECK(result.min == expected.min);
+        HOST_CHECK(result.max == expected.max);
+        HOST_CHECK(result.mean == expected.mean);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < QUERY_REPETITIONS; i++)
+        {
+            (void)pasco2_rollup_query(queries[q].range, &result);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double query_ns = elapsed_ns(&start, &end) / QUERY_REPETITIONS;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < SCAN_REPETITIONS; i++)
+        {
+            scan(first * result.resolution, &expected);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double scan_ns = elapsed_ns(&start, &end) / SCAN_REPETITIONS;
+
+        printf("%-6s %-10u %8u %8u %6u %6u %6u %12.1f %12.1f\n",
+               queries[q].name,
+               (unsigned int)result.resolution,
+               (unsigned int)result.buckets,
+               (unsigned int)result.count,
+               (unsigned int)result.min,
+               (unsigned int)result.max,
+               (unsigned int)result.mean,
+               query_ns,
+               scan_ns);
+    }
+
+    /* The ranges longer than the stored week still cover all samples */
+    HOST_CHECK(pasco2_rollup_query(31U * 86400U, &result));
+    HOST_CHECK(result.count == SAMPLE_COUNT);
+
+    /* The terminal output reports the same aggregate */
+    HOST_CHECK(pasco2_rollup_query(24U * 3600U, &result));
+    host_uart_clear();
+    pasco2_rollup_print_query(24U * 3600U);
+    char expected_line[32];
+    snprintf(expected_line, sizeof(expected_line), "Max: %u ppm\r\n", (unsigned int)result.max);
+    HOST_CHECK(strstr(host_uart_output, expected_line) != NULL);
+    HOST_CHECK(strstr(host_uart_output, "hour buckets") != NULL);
+    return EXIT_SUCCESS;
+}
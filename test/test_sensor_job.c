@@ -0,0 +1,459 @@
+/*****************************************************************************
+** File name: test_sensor_job.c
+**
+** Description: Host simulation of the sensor, LED and log jobs on the
+** executor. A sensor model answers the driver calls and blocks the executor
+** for the time of a transfer, during which a key is pressed. The
+** measurements are compared with a model of the task loop the jobs replaced:
+** the same reads at the same times, except that a persistent warning is
+** polled after a back-off instead of continuously.
+** The test is built for every board variant, pins set to NC must never be
+** driven.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cybsp.h"
+#include "cyhal.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_board.h"
+#include "pasco2_config_store.h"
+#include "pasco2_executor.h"
+#include "pasco2_task.h"
+
+/* Time in ms the executor waits for one sensor transfer */
+#define SENSOR_TRANSFER_TIME (4U)
+/* A key pressed during a transfer waits for the rest of the sensor job run,
+ * at most a period request and a read */
+#define KEY_LATENCY_MAX (2U * SENSOR_TRANSFER_TIME)
+/* Delays in ms of the replaced task loop: power-up, after a value and after
+ * an information, a warning was polled again immediately */
+#define LOOP_POWER_UP_DELAY (2000U)
+#define LOOP_VALUE_DELAY    (10000U)
+#define LOOP_INFO_DELAY     (1000U)
+#define LOOP_WARNING_DELAY  (0U)
+/* Time in ms the sensor reports no value yet and a voltage error */
+#define PENDING_BEGIN (30000U)
+#define PENDING_END   (33000U)
+#define WARNING_BEGIN (60000U)
+#define WARNING_END   (70000U)
+/* Time in ms the terminal UI requests a measurement period */
+#define REQUEST_TIME (75000U)
+/* Requested measurement period in s */
+#define REQUEST_PERIOD (30U)
+/* End of the simulation in ms */
+#define SIMULATION_END (120000U)
+/* Maximum number of reads recorded */
+#define READ_COUNT_MAX (2048U)
+
+/* Event of the key job */
+#define KEY_EVENT_PRESSED (PASCO2_EXECUTOR_EVENT_USER << 0)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+/* Start times of the reads of the jobs */
+static uint32_t read_times[READ_COUNT_MAX];
+static uint32_t read_count = 0;
+
+/* Measurement period written to the sensor, 0 if never set */
+static uint16_t sensor_period = 0;
+
+/* Number of initialized output pins */
+static uint32_t gpio_outputs = 0;
+/* State of the warning LED and number of times it was turned on */
+static bool warning_led = false;
+static uint32_t warning_led_on = 0;
+/* Time of the oldest key press not yet handled by the key job */
+static bool key_pending = false;
+static uint32_t key_pressed_time = 0;
+/* Longest time in ms from a key press until the key job handled it */
+static uint32_t key_latency = 0;
+
+static void key_job_run(pasco2_job_t *job, uint32_t events);
+static pasco2_job_t key_job = {.name = "key", .handler = key_job_run};
+
+/*******************************************************************************
+ * Function Name: sensor_model
+ *******************************************************************************
+ * Summary:
+ *   Returns the answer of the sensor to a read at the given time.
+ *******************************************************************************/
+static cy_rslt_t sensor_model(uint32_t time, uint16_t *ppm)
+{
+    if ((time >= PENDING_BEGIN) && (time < PENDING_END))
+    {
+        return CY_RSLT_CREATE(CY_RSLT_TYPE_INFO, CY_RSLT_MODULE_MIDDLEWARE_BASE, MTB_PASCO2_PPM_PENDING);
+    }
+    if ((time >= WARNING_BEGIN) && (time < WARNING_END))
+    {
+        return CY_RSLT_CREATE(CY_RSLT_TYPE_WARNING, CY_RSLT_MODULE_MIDDLEWARE_BASE, MTB_PASCO2_VOLTAGE_ERROR);
+    }
+    *ppm = (uint16_t)(400U + ((time / 1000U) % 600U));
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: count_warning_reads
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of reads while the sensor reports the warning.
+ *******************************************************************************/
+static uint32_t count_warning_reads(const uint32_t times[], uint32_t count)
+{
+    uint32_t reads = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        reads += ((times[i] >= WARNING_BEGIN) && (times[i] < WARNING_END)) ? 1U : 0U;
+    }
+    return reads;
+}
+
+/*******************************************************************************
+ * Function Name: loop_model
+ *******************************************************************************
+ * Summary:
+ *   Returns the start times of the reads of the replaced task loop, which
+ *   waited for a delay after every read. The delay after a warning is given.
+ *******************************************************************************/
+static uint32_t loop_model(uint32_t warning_delay, uint32_t times[READ_COUNT_MAX])
+{
+    uint32_t count = 0;
+    uint32_t time = LOOP_POWER_UP_DELAY + SENSOR_TRANSFER_TIME;
+    while ((time < SIMULATION_END) && (count < READ_COUNT_MAX))
+    {
+        uint16_t ppm;
+        cy_rslt_t result = sensor_model(time, &ppm);
+        times[count++] = time;
+        time += SENSOR_TRANSFER_TIME;
+        if (result == CY_RSLT_SUCCESS)
+        {
+            time += LOOP_VALUE_DELAY;
+        }
+        else if (CY_RSLT_GET_TYPE(result) == CY_RSLT_TYPE_INFO)
+        {
+            time += LOOP_INFO_DELAY;
+        }
+        else
+        {
+            time += warning_delay;
+        }
+    }
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: sensor_transfer
+ *******************************************************************************
+ * Summary:
+ *   Blocks the executor for one transfer. A key is pressed at its start, the
+ *   UART interrupt signals the key job.
+ *******************************************************************************/
+static void sensor_transfer(void)
+{
+    if (!key_pending)
+    {
+        key_pending = true;
+        key_pressed_time = host_time_ms;
+    }
+    pasco2_executor_signal(&key_job, KEY_EVENT_PRESSED);
+    host_time_ms += SENSOR_TRANSFER_TIME;
+}
+
+/*******************************************************************************
+ * Function Name: mtb_pasco2_init
+ *******************************************************************************/
+cy_rslt_t mtb_pasco2_init(mtb_pasco2_context_t *context, cyhal_i2c_t *i2c)
+{
+    sensor_transfer();
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: mtb_pasco2_get_ppm
+ *******************************************************************************/
+cy_rslt_t mtb_pasco2_get_ppm(mtb_pasco2_context_t *context, uint16_t *ppm)
+{
+    HOST_CHECK(read_count < READ_COUNT_MAX);
+    read_times[read_count++] = host_time_ms;
+    cy_rslt_t result = sensor_model(host_time_ms, ppm);
+    sensor_transfer();
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: mtb_pasco2_set_config
+ *******************************************************************************/
+cy_rslt_t mtb_pasco2_set_config(mtb_pasco2_context_t *context, const mtb_pasco2_config_t *config)
+{
+    sensor_transfer();
+    sensor_period = config->measurement_period;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: key_job_run
+ *******************************************************************************
+ * Summary:
+ *   Stands in for the terminal UI job and records how long a key press
+ *   waited for it.
+ *******************************************************************************/
+static void key_job_run(pasco2_job_t *job, uint32_t events)
+{
+    if (((events & KEY_EVENT_PRESSED) != 0U) && key_pending)
+    {
+        uint32_t latency = host_time_ms - key_pressed_time;
+        key_latency = (latency > key_latency) ? latency : key_latency;
+        key_pending = false;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_gpio_init
+ *******************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin,
+                          cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val)
+{
+    HOST_CHECK(pin != NC);
+    HOST_CHECK(direction == CYHAL_GPIO_DIR_OUTPUT);
+    gpio_outputs++;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_gpio_write
+ *******************************************************************************
+ * Summary:
+ *   Tracks the warning LED.
+ *******************************************************************************/
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    HOST_CHECK(pin != NC);
+    if (pin == MTB_PASCO2_LED_WARNING)
+    {
+        if (value && !warning_led)
+        {
+            warning_led_on++;
+        }
+        warning_led = value;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_i2c_init
+ *******************************************************************************/
+cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const void *clk)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_i2c_configure
+ *******************************************************************************/
+cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_write
+ *******************************************************************************
+ * Summary:
+ *   The bus functions below the register cache are not used, the driver is
+ *   replaced by the sensor model.
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_write(
+    cyhal_i2c_t *obj, uint16_t address, const uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    HOST_CHECK(false);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_read(
+    cyhal_i2c_t *obj, uint16_t address, uint8_t *data, uint16_t size, uint32_t timeout, bool send_stop)
+{
+    HOST_CHECK(false);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_write
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_write(cyhal_i2c_t *obj,
+                                            uint16_t address,
+                                            uint16_t mem_addr,
+                                            uint16_t mem_addr_size,
+                                            const uint8_t *data,
+                                            uint16_t size,
+                                            uint32_t timeout)
+{
+    HOST_CHECK(false);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: __real_cyhal_i2c_master_mem_read
+ *******************************************************************************/
+cy_rslt_t __real_cyhal_i2c_master_mem_read(cyhal_i2c_t *obj,
+                                           uint16_t address,
+                                           uint16_t mem_addr,
+                                           uint16_t mem_addr_size,
+                                           uint8_t *data,
+                                           uint16_t size,
+                                           uint32_t timeout)
+{
+    HOST_CHECK(false);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: simulate
+ *******************************************************************************
+ * Summary:
+ *   Runs the executor like its task does and sleeps until the next job
+ *   timer. The terminal UI requests a measurement period once.
+ *******************************************************************************/
+static void simulate(void)
+{
+    bool requested = false;
+    while (host_time_ms < SIMULATION_END)
+    {
+        if (!requested && (host_time_ms >= REQUEST_TIME))
+        {
+            pasco2_request_measurement_period(REQUEST_PERIOD);
+            requested = true;
+        }
+        host_time_ms += pasco2_executor_run();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: count_values
+ *******************************************************************************
+ * Summary:
+ *   Checks that the UART output holds the CO2 values of the successful reads
+ *   in order and nothing else, and returns their number.
+ *******************************************************************************/
+static uint32_t count_values(const uint32_t times[], uint32_t count)
+{
+    uint32_t values = 0;
+    const char *line = host_uart_output;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t ppm;
+        if (sensor_model(times[i], &ppm) != CY_RSLT_SUCCESS)
+        {
+            continue;
+        }
+        char expected[32];
+        snprintf(expected, sizeof(expected), "CO2 PPM Level: %u\r\n", (unsigned int)ppm);
+        line = strstr(line, expected);
+        HOST_CHECK(line != NULL);
+        line += strlen(expected);
+        values++;
+    }
+    HOST_CHECK(strstr(line, "CO2 PPM Level:") == NULL);
+    return values;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************/
+int main(void)
+{
+    static uint32_t loop_times[READ_COUNT_MAX];
+    static uint32_t busy_loop_times[READ_COUNT_MAX];
+
+    /* One file per variant, the variants may run in parallel */
+    static char eeprom_path[32];
+    snprintf(eeprom_path, sizeof(eeprom_path), "test_sensor_job_%d.bin", PASCO2_BOARD);
+    host_eeprom_path = eeprom_path;
+    remove(host_eeprom_path);
+
+    pasco2_task_init();
+    pasco2_executor_add(&key_job);
+    simulate();
+
+    /* The jobs read the sensor at the times of the replaced loop with the
+     * back-off after a warning */
+    uint32_t loop_count = loop_model(PASCO2_POLL_DELAY, loop_times);
+    HOST_CHECK(read_count == loop_count);
+    HOST_CHECK(memcmp(read_times, loop_times, read_count * sizeof(read_times[0])) == 0);
+
+    /* Up to the first warning the loop without back-off read at the same
+     * times, then it kept the sensor bus busy for the whole warning */
+    uint32_t busy_loop_count = loop_model(LOOP_WARNING_DELAY, busy_loop_times);
+    uint32_t same = 0;
+    while ((same < read_count) && (read_times[same] == busy_loop_times[same]) && (read_times[same] < WARNING_BEGIN))
+    {
+        same++;
+    }
+    HOST_CHECK(read_times[same] >= WARNING_BEGIN);
+    uint32_t warning_reads = count_warning_reads(read_times, read_count);
+    uint32_t busy_loop_warning_reads = count_warning_reads(busy_loop_times, busy_loop_count);
+    uint32_t warning_time = WARNING_END - read_times[same];
+    HOST_CHECK(warning_reads == (((warning_time - 1U) / (PASCO2_POLL_DELAY + SENSOR_TRANSFER_TIME)) + 1U));
+    HOST_CHECK(busy_loop_warning_reads == (((warning_time - 1U) / SENSOR_TRANSFER_TIME) + 1U));
+
+    /* The log job printed every value in order, the LED job initialized the
+     * connected pins and showed the warning once if the LED is connected */
+    uint32_t values = count_values(read_times, read_count);
+    HOST_CHECK(gpio_outputs == ((MTB_PASCO2_PSEL != NC) + (MTB_PASCO2_POWER_SWITCH != NC) +
+                                (MTB_PASCO2_LED_INIT != NC) + (MTB_PASCO2_LED_OK != NC) +
+                                (MTB_PASCO2_LED_WARNING != NC)));
+    HOST_CHECK(warning_led_on == ((MTB_PASCO2_LED_WARNING != NC) ? 1U : 0U));
+    HOST_CHECK(!warning_led);
+
+    /* The terminal UI waited for the sensor transfers of one job run only */
+    HOST_CHECK(!key_pending);
+    HOST_CHECK(key_latency <= KEY_LATENCY_MAX);
+
+    /* The requested period was written by the sensor job, reported by the log
+     * job and saved without moving the next measurement */
+    HOST_CHECK(sensor_period == REQUEST_PERIOD);
+    HOST_CHECK(strstr(host_uart_output, "CO2 measurement period set to: 30\r\n") != NULL);
+    /* The adaptive mode was never enabled, so the request did not end it */
+    HOST_CHECK(strstr(host_uart_output, "adaptive") == NULL);
+    HOST_CHECK(host_eeprom_writes == 1U);
+    pasco2_config_store_data_t data;
+    HOST_CHECK((pasco2_config_store_init() == CY_RSLT_SUCCESS) && pasco2_config_store_get(&data));
+    HOST_CHECK(data.measurement_period == REQUEST_PERIOD);
+
+    printf("%u reads, %u values, %u reads during a %u ms warning (%u without back-off), key latency %u ms\n",
+           (unsigned int)read_count,
+           (unsigned int)values,
+           (unsigned int)warning_reads,
+           (unsigned int)warning_time,
+           (unsigned int)busy_loop_warning_reads,
+           (unsigned int)key_latency);
+
+    remove(host_eeprom_path);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/*****************************************************************************
+** File name: test_trace.c
+**
+** Description: Host test of the kernel event tracer. Task slices with a
+** sensor driver span each are recorded until the ring has wrapped, with the
+** cycle counter overflowing in the retained part. The trace is checked record
+** by record, and the terminal dump is written to the file given as argument.
+** test_trace_convert.py converts the dump with
+** scripts/pasco2_trace_convert.py and checks the Chrome trace events.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "host_test.h"
+#include "pasco2_trace.h"
+
+/* Number of task slices, each with a switch in, a span and a switch out */
+#define SLICE_COUNT  (400U)
+#define SLICE_EVENTS (4U)
+/* Cycles between two events */
+#define EVENT_CYCLES (1000U)
+/* Event after which the cycle counter overflows */
+#define WRAP_EVENT (1000U)
+/* Number of tasks the slices rotate over */
+#define TASK_COUNT (3U)
+
+/* Task number and span of a slice */
+#define SLICE_TASK(slice) (1U + ((slice) % TASK_COUNT))
+#define SLICE_SPAN(slice) (((slice) % 2U) ? PASCO2_TRACE_SPAN_GET_PPM : PASCO2_TRACE_SPAN_SET_CONFIG)
+
+/*******************************************************************************
+ * Global Variables
+ *******************************************************************************/
+extern pasco2_trace_buffer_t pasco2_trace_buffer;
+
+static const char *const task_names[TASK_COUNT] = {"sensor", "ui", "IDLE"};
+
+/*******************************************************************************
+ * Function Name: record
+ *******************************************************************************
+ * Summary:
+ *   Advances the cycle counter and records an event.
+ *******************************************************************************/
+static void record(uint16_t event, uint32_t arg, uint16_t aux)
+{
+    DWT->CYCCNT += EVENT_CYCLES;
+    pasco2_trace_record(event, arg, aux);
+}
+
+/*******************************************************************************
+ * Function Name: check_record
+ *******************************************************************************
+ * Summary:
+ *   Compares the stored record of the given event number with the event the
+ *   test recorded.
+ *******************************************************************************/
+static void check_record(uint32_t number)
+{
+    const pasco2_trace_record_t *stored = &pasco2_trace_buffer.records[number % PASCO2_TRACE_BUFFER_EVENTS];
+    uint32_t slice = number / SLICE_EVENTS;
+    static const uint16_t events[SLICE_EVENTS] = {PASCO2_TRACE_EVT_TASK_SWITCHED_IN,
+                                                  PASCO2_TRACE_EVT_SPAN_BEGIN,
+                                                  PASCO2_TRACE_EVT_SPAN_END,
+                                                  PASCO2_TRACE_EVT_TASK_SWITCHED_OUT};
+    uint16_t event = events[number % SLICE_EVENTS];
+    bool span = (event == PASCO2_TRACE_EVT_SPAN_BEGIN) || (event == PASCO2_TRACE_EVT_SPAN_END);
+
+    HOST_CHECK(stored->event == event);
+    HOST_CHECK(stored->arg == (span ? SLICE_SPAN(slice) : SLICE_TASK(slice)));
+    HOST_CHECK(stored->timestamp == ((0U - (WRAP_EVENT * EVENT_CYCLES)) + ((number + 1U) * EVENT_CYCLES)));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Records the slices and writes the terminal dump to argv[1].
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    pasco2_trace_init();
+    HOST_CHECK(DWT->CYCCNT == 0U);
+    HOST_CHECK(pasco2_trace_buffer.timestamp_hz == SystemCoreClock);
+    for (uint32_t i = 0; i < TASK_COUNT; i++)
+    {
+        pasco2_trace_name_object(PASCO2_TRACE_OBJECT_TASK, i + 1U, task_names[i]);
+    }
+    /* A renamed task keeps its entry */
+    pasco2_trace_name_object(PASCO2_TRACE_OBJECT_TASK, 2U, "terminal ui task name");
+    HOST_CHECK(strcmp(pasco2_trace_buffer.names[1].name, "terminal ui tas") == 0);
+    HOST_CHECK(pasco2_trace_buffer.names[TASK_COUNT].type == 0U);
+
+    /* Start so that the counter overflows after WRAP_EVENT events */
+    DWT->CYCCNT = 0U - (WRAP_EVENT * EVENT_CYCLES);
+    for (uint32_t slice = 0; slice < SLICE_COUNT; slice++)
+    {
+        record(PASCO2_TRACE_EVT_TASK_SWITCHED_IN, SLICE_TASK(slice), 2U);
+        record(PASCO2_TRACE_EVT_SPAN_BEGIN, SLICE_SPAN(slice), 0U);
+        record(PASCO2_TRACE_EVT_SPAN_END, SLICE_SPAN(slice), 0U);
+        record(PASCO2_TRACE_EVT_TASK_SWITCHED_OUT, SLICE_TASK(slice), 2U);
+    }
+
+    /* The ring holds the latest events, the overflow lies within them */
+    const uint32_t total = SLICE_COUNT * SLICE_EVENTS;
+    HOST_CHECK(pasco2_trace_buffer.head == total);
+    HOST_CHECK((total - PASCO2_TRACE_BUFFER_EVENTS) < WRAP_EVENT);
+    for (uint32_t number = total - PASCO2_TRACE_BUFFER_EVENTS; number < total; number++)
+    {
+        check_record(number);
+    }
+
+    /* Nothing is recorded while paused, and the dump does not record either */
+    pasco2_trace_enable(false);
+    record(PASCO2_TRACE_EVT_ISR_ENTER, 0U, 0U);
+    pasco2_trace_enable(true);
+    host_uart_clear();
+    pasco2_trace_dump();
+    HOST_CHECK(pasco2_trace_buffer.head == total);
+    HOST_CHECK(strstr(host_uart_output, "PASCO2-TRACE-BEGIN\r\n") == host_uart_output);
+    HOST_CHECK(strstr(host_uart_output, "\r\nPASCO2-TRACE-END\r\n") != NULL);
+    printf("%u events recorded, %u stored\n", (unsigned int)total, PASCO2_TRACE_BUFFER_EVENTS);
+
+    if (argc > 1)
+    {
+        FILE *file = fopen(argv[1], "w");
+        HOST_CHECK(file != NULL);
+        HOST_CHECK(fwrite(host_uart_output, 1U, host_uart_length, file) == host_uart_length);
+        fclose(file);
+    }
+    return EXIT_SUCCESS;
+}
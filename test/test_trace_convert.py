@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Host test of scripts/pasco2_trace_convert.py.
+
+Runs test_trace to get the terminal dump of a wrapped trace ring, converts it
+and checks the Chrome trace events: one event per stored record, timestamps
+unwrapped across the cycle counter overflow, task slices as matching B/E
+pairs and sensor spans as matching b/e pairs within them.
+
+Usage: test_trace_convert.py <test_trace> <pasco2_trace_convert.py>
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+# Must match test_trace.c and the host SystemCoreClock
+STORED_EVENTS = 1024
+FIRST_EVENT = 400 * 4 - STORED_EVENTS
+EVENT_US = 1000 * 1e6 / 100000000
+TASK_NAMES = {1: "sensor", 2: "terminal ui tas", 3: "IDLE"}
+SPAN_NAMES = {2: "mtb_pasco2_get_ppm", 3: "mtb_pasco2_set_config"}
+
+
+def check(condition, message):
+    if not condition:
+        sys.exit("check failed: " + message)
+
+
+def slice_task(number):
+    return 1 + (number // 4) % 3
+
+
+def slice_span(number):
+    return 2 if (number // 4) % 2 else 3
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    with tempfile.TemporaryDirectory() as directory:
+        log = os.path.join(directory, "trace.log")
+        output = os.path.join(directory, "trace.json")
+        subprocess.run([sys.argv[1], log], check=True)
+        result = subprocess.run([sys.executable, sys.argv[2], log, output], check=True, capture_output=True,
+                                text=True)
+        check(result.stdout.strip() == "%d events converted" % STORED_EVENTS, result.stdout)
+        with open(output) as f:
+            trace = json.load(f)
+
+    events = [event for event in trace["traceEvents"] if event["ph"] != "M"]
+    check(len(events) == STORED_EVENTS, "%d events" % len(events))
+
+    # The events keep the recording order, 10 us apart also across the
+    # overflow of the cycle counter
+    for previous, event in zip(events, events[1:]):
+        check(abs(event["ts"] - previous["ts"] - EVENT_US) < 1e-6, "ts %r after %r" % (event, previous))
+
+    # Every slice switches a task in, runs a span and switches the task out
+    depth = {}
+    open_span = None
+    for i, event in enumerate(events):
+        number = FIRST_EVENT + i
+        task = slice_task(number)
+        kind = number % 4
+        if kind == 0:
+            check(event["ph"] == "B" and event["tid"] == task, "switch in %r" % event)
+            check(event["name"] == TASK_NAMES[task], "task name %r" % event)
+            depth[task] = depth.get(task, 0) + 1
+            check(sum(depth.values()) == 1, "nested slices at %r" % event)
+        elif kind == 1:
+            check(event["ph"] == "b" and event["id"] == slice_span(number), "span begin %r" % event)
+            check(event["name"] == SPAN_NAMES[event["id"]] and event["tid"] == task, "span %r" % event)
+            open_span = event["id"]
+        elif kind == 2:
+            check(event["ph"] == "e" and event["id"] == open_span, "span end %r" % event)
+            check(event["args"]["result"] == 0, "span result %r" % event)
+            open_span = None
+        else:
+            check(event["ph"] == "E" and event["tid"] == task, "switch out %r" % event)
+            depth[task] -= 1
+    check(all(count == 0 for count in depth.values()) and open_span is None, "unmatched B/E at the end")
+
+    threads = {event["tid"]: event["args"]["name"] for event in trace["traceEvents"]
+               if event["ph"] == "M" and event["name"] == "thread_name"}
+    for task, name in TASK_NAMES.items():
+        check(threads.get(task) == name, "thread name of task %d" % task)
+    print("%d events converted, %.2f ms" % (len(events), (events[-1]["ts"] - events[0]["ts"]) / 1000))
+
+
+if __name__ == "__main__":
+    main()